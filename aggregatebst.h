@@ -0,0 +1,370 @@
+#ifndef AGGREGATEBST_H
+#define AGGREGATEBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <utility>
+#include <functional>
+#include "bst.h"
+#include "avlbst.h"
+
+/**
+* An AVLNode that also caches the combined value of every live item in its
+* subtree. A subtree holding only tombstones has no aggregate.
+*/
+template <typename Key, typename Value>
+class AggregateNode : public AVLNode<Key, Value>
+{
+public:
+    AggregateNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent);
+    virtual ~AggregateNode();
+
+    bool hasAggregate() const;
+    const Value& getAggregate() const;
+    void setAggregate(const Value& aggregate);
+    void clearAggregate();
+
+protected:
+    Value aggregate_;
+    bool hasAggregate_;
+};
+
+/*
+  --------------------------------------------------
+  Begin implementations for the AggregateNode class.
+  --------------------------------------------------
+*/
+
+template<typename Key, typename Value>
+AggregateNode<Key, Value>::AggregateNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent) :
+    AVLNode<Key, Value>(key, value, parent), aggregate_(value), hasAggregate_(true)
+{
+
+}
+
+template<typename Key, typename Value>
+AggregateNode<Key, Value>::~AggregateNode()
+{
+
+}
+
+template<typename Key, typename Value>
+bool AggregateNode<Key, Value>::hasAggregate() const
+{
+    return hasAggregate_;
+}
+
+/**
+* The combined value of the live items in this subtree, in key order. Only
+* meaningful when hasAggregate() is true.
+*/
+template<typename Key, typename Value>
+const Value& AggregateNode<Key, Value>::getAggregate() const
+{
+    return aggregate_;
+}
+
+template<typename Key, typename Value>
+void AggregateNode<Key, Value>::setAggregate(const Value& aggregate)
+{
+    aggregate_ = aggregate;
+    hasAggregate_ = true;
+}
+
+template<typename Key, typename Value>
+void AggregateNode<Key, Value>::clearAggregate()
+{
+    hasAggregate_ = false;
+}
+
+/*
+  ------------------------------------------------
+  End implementations for the AggregateNode class.
+  ------------------------------------------------
+*/
+
+/**
+* An AVLTree whose nodes cache the combination of the values in their
+* subtree under a user-supplied associative Combine (sum by default; min,
+* max, gcd, matrix product, ... all work). Combine is always applied in key
+* order, so it does not need to be commutative, and no identity element is
+* needed either. aggregate(lo, hi) then answers a range query in O(log n)
+* instead of walking the range.
+*
+* Rotations, rebuilds and the insert/remove retrace keep the cached values
+* up to date. Values must only change through insert: writing through an
+* iterator would bypass the cache, so operator[] is read-only here.
+*/
+template <typename Key, typename Value, typename Combine = std::plus<Value>,
+          typename Alloc = std::allocator<std::pair<const Key, Value> > >
+class AggregateTree : public AVLTree<Key, Value, Alloc>
+{
+public:
+    AggregateTree();
+    explicit AggregateTree(const Combine& combine, const Alloc& alloc = Alloc());
+    AggregateTree(const AggregateTree& other);
+    AggregateTree(AggregateTree&& other);
+    AggregateTree& operator=(const AggregateTree& other);
+    AggregateTree& operator=(AggregateTree&& other);
+    void swap(AggregateTree& other);
+    virtual ~AggregateTree();
+
+    bool aggregate(const Key& lo, const Key& hi, Value& out) const;
+    bool aggregateAll(Value& out) const;
+    const Value& operator[](const Key& key) const;
+
+protected:
+    typedef AggregateNode<Key, Value> NodeType;
+
+    virtual AVLNode<Key, Value>* createNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent);
+    virtual void destroyNode(Node<Key, Value>* node);
+    virtual void augmentNode(Node<Key, Value>* node);
+    virtual void augmentPath(Node<Key, Value>* node);
+    virtual void swapTree(BinarySearchTree<Key, Value, Alloc>& other);
+    void append(bool& has, Value& acc, const Value& value) const;
+    void prepend(bool& has, Value& acc, const Value& value) const;
+
+    Combine combine_;
+};
+
+template<typename Key, typename Value, typename Combine, typename Alloc>
+AggregateTree<Key, Value, Combine, Alloc>::AggregateTree() : AVLTree<Key, Value, Alloc>(), combine_()
+{
+
+}
+
+template<typename Key, typename Value, typename Combine, typename Alloc>
+AggregateTree<Key, Value, Combine, Alloc>::AggregateTree(const Combine& combine, const Alloc& alloc) :
+    AVLTree<Key, Value, Alloc>(alloc), combine_(combine)
+{
+
+}
+
+/**
+* Deep copy in O(n); nodes are cloned as AggregateNodes, aggregates included.
+*/
+template<typename Key, typename Value, typename Combine, typename Alloc>
+AggregateTree<Key, Value, Combine, Alloc>::AggregateTree(const AggregateTree<Key, Value, Combine, Alloc>& other) :
+    AVLTree<Key, Value, Alloc>(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.get_allocator())),
+    combine_(other.combine_)
+{
+    this->template copyFrom<NodeType>(other);
+    this->tombstoneMode_ = other.tombstoneMode_;
+    this->compactThreshold_ = other.compactThreshold_;
+    this->relaxedBound_ = other.relaxedBound_;
+    this->dead_ = other.dead_;
+}
+
+/**
+* Move constructor; O(1), leaves other empty.
+*/
+template<typename Key, typename Value, typename Combine, typename Alloc>
+AggregateTree<Key, Value, Combine, Alloc>::AggregateTree(AggregateTree<Key, Value, Combine, Alloc>&& other) :
+    AVLTree<Key, Value, Alloc>(std::move(other)), combine_(other.combine_)
+{
+
+}
+
+template<typename Key, typename Value, typename Combine, typename Alloc>
+AggregateTree<Key, Value, Combine, Alloc>& AggregateTree<Key, Value, Combine, Alloc>::operator=(const AggregateTree<Key, Value, Combine, Alloc>& other)
+{
+    if(this != &other){
+      AggregateTree<Key, Value, Combine, Alloc> copy(other);
+      this->swapTree(copy);
+    }
+    return *this;
+}
+
+template<typename Key, typename Value, typename Combine, typename Alloc>
+AggregateTree<Key, Value, Combine, Alloc>& AggregateTree<Key, Value, Combine, Alloc>::operator=(AggregateTree<Key, Value, Combine, Alloc>&& other)
+{
+    this->swapTree(other);
+    return *this;
+}
+
+template<typename Key, typename Value, typename Combine, typename Alloc>
+void AggregateTree<Key, Value, Combine, Alloc>::swap(AggregateTree<Key, Value, Combine, Alloc>& other)
+{
+    this->swapTree(other);
+}
+
+/**
+* Frees the nodes here so they are freed as AggregateNodes.
+*/
+template<typename Key, typename Value, typename Combine, typename Alloc>
+AggregateTree<Key, Value, Combine, Alloc>::~AggregateTree()
+{
+    this->clear();
+}
+
+/**
+* Combines the values of every item with lo <= key <= hi, in key order, into
+* out. Returns false, leaving out alone, if there are no such items.
+*
+* The search paths to lo and hi split at one node; below it, each path
+* picks up whole cached subtrees on its inner side, so O(log n) in all.
+*/
+template<typename Key, typename Value, typename Combine, typename Alloc>
+bool AggregateTree<Key, Value, Combine, Alloc>::aggregate(const Key& lo, const Key& hi, Value& out) const
+{
+    NodeType* split = static_cast<NodeType*>(this->root_);
+    while(split != nullptr){ // find the highest node inside [lo, hi]
+      if(split->getKey() < lo){
+        split = static_cast<NodeType*>(split->getRight());
+      }
+      else if(hi < split->getKey()){
+        split = static_cast<NodeType*>(split->getLeft());
+      }
+      else{
+        break;
+      }
+    }
+    if(split == nullptr){
+      return false;
+    }
+
+    bool has = false;
+    Value acc = Value();
+    if(!split->isDead()){
+      append(has, acc, split->getValue());
+    }
+
+    // left path: each node >= lo brings itself and its right subtree, all of
+    // which come before what has been collected so far
+    NodeType* node = static_cast<NodeType*>(split->getLeft());
+    while(node != nullptr){
+      if(node->getKey() < lo){
+        node = static_cast<NodeType*>(node->getRight());
+        continue;
+      }
+      NodeType* right = static_cast<NodeType*>(node->getRight());
+      if(right != nullptr && right->hasAggregate()){
+        prepend(has, acc, right->getAggregate());
+      }
+      if(!node->isDead()){
+        prepend(has, acc, node->getValue());
+      }
+      node = static_cast<NodeType*>(node->getLeft());
+    }
+
+    // right path: the mirror image, appending left subtrees and nodes <= hi
+    node = static_cast<NodeType*>(split->getRight());
+    while(node != nullptr){
+      if(hi < node->getKey()){
+        node = static_cast<NodeType*>(node->getLeft());
+        continue;
+      }
+      NodeType* left = static_cast<NodeType*>(node->getLeft());
+      if(left != nullptr && left->hasAggregate()){
+        append(has, acc, left->getAggregate());
+      }
+      if(!node->isDead()){
+        append(has, acc, node->getValue());
+      }
+      node = static_cast<NodeType*>(node->getRight());
+    }
+
+    if(has){
+      out = acc;
+    }
+    return has;
+}
+
+/**
+* Combines every value in the tree into out in O(1). Returns false if the
+* tree holds no live items.
+*/
+template<typename Key, typename Value, typename Combine, typename Alloc>
+bool AggregateTree<Key, Value, Combine, Alloc>::aggregateAll(Value& out) const
+{
+    NodeType* root = static_cast<NodeType*>(this->root_);
+    if(root == nullptr || !root->hasAggregate()){
+      return false;
+    }
+    out = root->getAggregate();
+    return true;
+}
+
+/**
+* Read-only lookup; hides the writable operator[] so values cannot change
+* behind the cached aggregates. Use insert to update a value.
+*/
+template<typename Key, typename Value, typename Combine, typename Alloc>
+const Value& AggregateTree<Key, Value, Combine, Alloc>::operator[](const Key& key) const
+{
+    return AVLTree<Key, Value, Alloc>::operator[](key);
+}
+
+template<typename Key, typename Value, typename Combine, typename Alloc>
+void AggregateTree<Key, Value, Combine, Alloc>::append(bool& has, Value& acc, const Value& value) const
+{
+    acc = has ? combine_(acc, value) : value;
+    has = true;
+}
+
+template<typename Key, typename Value, typename Combine, typename Alloc>
+void AggregateTree<Key, Value, Combine, Alloc>::prepend(bool& has, Value& acc, const Value& value) const
+{
+    acc = has ? combine_(value, acc) : value;
+    has = true;
+}
+
+template<typename Key, typename Value, typename Combine, typename Alloc>
+AVLNode<Key, Value>* AggregateTree<Key, Value, Combine, Alloc>::createNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent)
+{
+    return this->template allocateNode<NodeType>(key, value, parent);
+}
+
+template<typename Key, typename Value, typename Combine, typename Alloc>
+void AggregateTree<Key, Value, Combine, Alloc>::destroyNode(Node<Key, Value>* node)
+{
+    this->deallocateNode(static_cast<NodeType*>(node));
+}
+
+/**
+* aggregate = left aggregate + own value + right aggregate, skipping
+* whatever is missing (no child, a tombstone, an all-tombstone subtree).
+*/
+template<typename Key, typename Value, typename Combine, typename Alloc>
+void AggregateTree<Key, Value, Combine, Alloc>::augmentNode(Node<Key, Value>* node)
+{
+    NodeType* current = static_cast<NodeType*>(node);
+    NodeType* left = static_cast<NodeType*>(current->getLeft());
+    NodeType* right = static_cast<NodeType*>(current->getRight());
+    bool has = false;
+    Value acc = Value();
+    if(left != nullptr && left->hasAggregate()){
+      append(has, acc, left->getAggregate());
+    }
+    if(!current->isDead()){
+      append(has, acc, current->getValue());
+    }
+    if(right != nullptr && right->hasAggregate()){
+      append(has, acc, right->getAggregate());
+    }
+    if(has){
+      current->setAggregate(acc);
+    }
+    else{
+      current->clearAggregate();
+    }
+}
+
+template<typename Key, typename Value, typename Combine, typename Alloc>
+void AggregateTree<Key, Value, Combine, Alloc>::augmentPath(Node<Key, Value>* node)
+{
+    while(node != nullptr){
+      augmentNode(node);
+      node = node->getParent();
+    }
+}
+
+template<typename Key, typename Value, typename Combine, typename Alloc>
+void AggregateTree<Key, Value, Combine, Alloc>::swapTree(BinarySearchTree<Key, Value, Alloc>& other)
+{
+    AVLTree<Key, Value, Alloc>::swapTree(other);
+    std::swap(combine_, static_cast<AggregateTree<Key, Value, Combine, Alloc>&>(other).combine_);
+}
+
+#endif
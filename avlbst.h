@@ -6,6 +6,8 @@
 #include <cstdlib>
 #include <cstdint>
 #include <algorithm>
+#include <vector>
+#include <stdexcept>
 #include "bst.h"
 
 struct KeyError { };
@@ -28,6 +30,14 @@ public:
     void setBalance (int8_t balance);
     void updateBalance(int8_t diff);
 
+    // Tombstone flag, see AVLTree::setTombstones.
+    bool isDead() const;
+    void setDead(bool dead);
+
+    // Relaxed-balance flag, see AVLTree::setRelaxedBalance.
+    bool isPending() const;
+    void setPending(bool pending);
+
     // Getters for parent, left, and right. These need to be redefined since they
     // return pointers to AVLNodes - not plain Nodes. See the Node class in bst.h
     // for more information.
@@ -37,6 +47,8 @@ public:
 
 protected:
     int8_t balance_;    // effectively a signed char
+    bool dead_;         // removed in tombstone mode; fits in the padding after balance_
+    bool pending_;      // relaxed mode changed this subtree; balance may be stale. Also in the padding
 };
 
 /*
@@ -50,7 +62,7 @@ protected:
 */
 template<class Key, class Value>
 AVLNode<Key, Value>::AVLNode(const Key& key, const Value& value, AVLNode<Key, Value> *parent) :
-    Node<Key, Value>(key, value, parent), balance_(0)
+    Node<Key, Value>(key, value, parent), balance_(0), dead_(false), pending_(false)
 {
 
 }
@@ -91,6 +103,39 @@ void AVLNode<Key, Value>::updateBalance(int8_t diff)
     balance_ += diff;
 }
 
+/**
+* True if the node was removed in tombstone mode and is only kept until the
+* next compaction.
+*/
+template<class Key, class Value>
+bool AVLNode<Key, Value>::isDead() const
+{
+    return dead_;
+}
+
+template<class Key, class Value>
+void AVLNode<Key, Value>::setDead(bool dead)
+{
+    dead_ = dead;
+}
+
+/**
+* True if relaxed-mode writes changed this subtree since the last
+* rebalance(), so its balance and shape are not to be trusted. Every
+* ancestor of a pending node is pending too.
+*/
+template<class Key, class Value>
+bool AVLNode<Key, Value>::isPending() const
+{
+    return pending_;
+}
+
+template<class Key, class Value>
+void AVLNode<Key, Value>::setPending(bool pending)
+{
+    pending_ = pending;
+}
+
 /**
 * An overridden function for getting the parent since a static_cast is necessary to make sure
 * that our node is a AVLNode.
@@ -107,7 +152,7 @@ AVLNode<Key, Value> *AVLNode<Key, Value>::getParent() const
 template<class Key, class Value>
 AVLNode<Key, Value> *AVLNode<Key, Value>::getLeft() const
 {
-    return static_cast<AVLNode<Key, Value>*>(this->left_);
+    return static_cast<AVLNode<Key, Value>*>(this->child_[0]);
 }
 
 /**
@@ -116,7 +161,7 @@ AVLNode<Key, Value> *AVLNode<Key, Value>::getLeft() const
 template<class Key, class Value>
 AVLNode<Key, Value> *AVLNode<Key, Value>::getRight() const
 {
-    return static_cast<AVLNode<Key, Value>*>(this->right_);
+    return static_cast<AVLNode<Key, Value>*>(this->child_[1]);
 }
 
 
@@ -127,58 +172,201 @@ AVLNode<Key, Value> *AVLNode<Key, Value>::getRight() const
 */
 
 
-template <class Key, class Value>
-class AVLTree : public BinarySearchTree<Key, Value>
+template <class Key, class Value,
+          class Alloc = std::allocator<std::pair<const Key, Value> > >
+class AVLTree : public BinarySearchTree<Key, Value, Alloc>
 {
 public:
+    AVLTree();
+    explicit AVLTree(const Alloc& alloc);
+    AVLTree(const AVLTree& other);
+    AVLTree(AVLTree&& other);
+    AVLTree& operator=(const AVLTree& other);
+    AVLTree& operator=(AVLTree&& other);
+    void swap(AVLTree& other);
+    virtual ~AVLTree();
     virtual void insert (const std::pair<const Key, Value> &new_item); // TODO
     virtual void remove(const Key& key);  // TODO
+    virtual size_t eraseRange(const Key& lo, const Key& hi);
+    virtual void clear();
+    void setTombstones(bool enabled, double compactThreshold = 0.25);
+    virtual void compact();
+    size_t tombstones() const;
+    virtual void setScapegoatAlpha(double alpha);
+    void setRelaxedBalance(int bound);
+    int relaxedBalance() const;
+    void rebalance();
+    template<typename InputIt>
+    void assignSorted(InputIt first, InputIt last);
 protected:
     virtual void nodeSwap( AVLNode<Key,Value>* n1, AVLNode<Key,Value>* n2);
+    virtual Node<Key, Value>* internalFind(const Key& key) const;
+    virtual Node<Key, Value>* nextNode(Node<Key, Value>* current) const;
+    virtual Node<Key, Value>* prevNode(Node<Key, Value>* current) const;
+    virtual Node<Key, Value>* firstVisible(Node<Key, Value>* node) const;
+    virtual Node<Key, Value>* lastVisible(Node<Key, Value>* node) const;
+    virtual bool isVisible(Node<Key, Value>* node) const;
+    virtual void rebuiltNode(Node<Key, Value>* node, int leftHeight, int rightHeight);
+    virtual void swapTree(BinarySearchTree<Key, Value, Alloc>& other);
 
     // Add helper functions here
+    virtual AVLNode<Key, Value>* createNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent);
+    virtual void destroyNode(Node<Key, Value>* node);
     void leftRotation(AVLNode<Key, Value>* node);
     void rightRotation(AVLNode<Key, Value>* node);
     void rebalanceHelper(AVLNode<Key, Value>* node);
+    static void markPending(AVLNode<Key, Value>* node);
+    AVLNode<Key, Value>* repairSubtree(AVLNode<Key, Value>* node, int& height);
 
+    // split/join on detached subtrees whose heights are passed along
+    static int subtreeHeight(AVLNode<Key, Value>* node);
+    static void childHeights(AVLNode<Key, Value>* node, int height, int& leftHeight, int& rightHeight);
+    AVLNode<Key, Value>* linkNode(AVLNode<Key, Value>* left, int leftHeight, AVLNode<Key, Value>* node,
+                                  AVLNode<Key, Value>* right, int rightHeight, int& height);
+    AVLNode<Key, Value>* rotateLinkedLeft(AVLNode<Key, Value>* node, int height, int& newHeight);
+    AVLNode<Key, Value>* rotateLinkedRight(AVLNode<Key, Value>* node, int height, int& newHeight);
+    AVLNode<Key, Value>* joinNodes(AVLNode<Key, Value>* left, int leftHeight, AVLNode<Key, Value>* node,
+                                   AVLNode<Key, Value>* right, int rightHeight, int& height);
+    AVLNode<Key, Value>* joinRight(AVLNode<Key, Value>* left, int leftHeight, AVLNode<Key, Value>* node,
+                                   AVLNode<Key, Value>* right, int rightHeight, int& height);
+    AVLNode<Key, Value>* joinLeft(AVLNode<Key, Value>* left, int leftHeight, AVLNode<Key, Value>* node,
+                                  AVLNode<Key, Value>* right, int rightHeight, int& height);
+    void splitNodes(AVLNode<Key, Value>* node, int height, const Key& key, bool equalGoesLeft,
+                    AVLNode<Key, Value>*& left, int& leftHeight, AVLNode<Key, Value>*& right, int& rightHeight);
+    AVLNode<Key, Value>* popLast(AVLNode<Key, Value>* node, int height, AVLNode<Key, Value>*& rest, int& restHeight);
 
+    bool tombstoneMode_;        // remove only marks nodes dead
+    double compactThreshold_;   // compact once dead nodes exceed this fraction
+    size_t dead_;               // dead nodes still in the tree (not counted in size_)
+    int relaxedBound_;          // relaxed mode lets depth reach this times log2(size); 1 is strict AVL
 };
 
+template<class Key, class Value, class Alloc>
+AVLTree<Key, Value, Alloc>::AVLTree() : BinarySearchTree<Key, Value, Alloc>(),
+    tombstoneMode_(false), compactThreshold_(0.25), dead_(0), relaxedBound_(1)
+{
+
+}
+
+/**
+* Constructor taking an allocator instance, see BinarySearchTree.
+*/
+template<class Key, class Value, class Alloc>
+AVLTree<Key, Value, Alloc>::AVLTree(const Alloc& alloc) : BinarySearchTree<Key, Value, Alloc>(alloc),
+    tombstoneMode_(false), compactThreshold_(0.25), dead_(0), relaxedBound_(1)
+{
+
+}
+
+/**
+* Deep copy in O(n); nodes are cloned as AVLNodes.
+*/
+template<class Key, class Value, class Alloc>
+AVLTree<Key, Value, Alloc>::AVLTree(const AVLTree<Key, Value, Alloc>& other) :
+    BinarySearchTree<Key, Value, Alloc>(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.get_allocator())),
+    tombstoneMode_(other.tombstoneMode_), compactThreshold_(other.compactThreshold_), dead_(0),
+    relaxedBound_(other.relaxedBound_)
+{
+    this->template copyFrom<AVLNode<Key, Value> >(other);
+    dead_ = other.dead_; // the dead flags were copied with the nodes
+}
+
+/**
+* Move constructor; O(1), leaves other empty.
+*/
+template<class Key, class Value, class Alloc>
+AVLTree<Key, Value, Alloc>::AVLTree(AVLTree<Key, Value, Alloc>&& other) :
+    BinarySearchTree<Key, Value, Alloc>(std::move(other)),
+    tombstoneMode_(other.tombstoneMode_), compactThreshold_(other.compactThreshold_), dead_(other.dead_),
+    relaxedBound_(other.relaxedBound_)
+{
+    other.dead_ = 0;
+}
+
+template<class Key, class Value, class Alloc>
+AVLTree<Key, Value, Alloc>& AVLTree<Key, Value, Alloc>::operator=(const AVLTree<Key, Value, Alloc>& other)
+{
+    if(this != &other){
+      AVLTree<Key, Value, Alloc> copy(other);
+      this->swapTree(copy);
+    }
+    return *this;
+}
+
+/**
+* Move assignment in O(1) by swapping contents.
+*/
+template<class Key, class Value, class Alloc>
+AVLTree<Key, Value, Alloc>& AVLTree<Key, Value, Alloc>::operator=(AVLTree<Key, Value, Alloc>&& other)
+{
+    this->swapTree(other);
+    return *this;
+}
+
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::swap(AVLTree<Key, Value, Alloc>& other)
+{
+    this->swapTree(other);
+}
+
+/**
+* Frees the nodes here so they are freed as AVLNodes.
+*/
+template<class Key, class Value, class Alloc>
+AVLTree<Key, Value, Alloc>::~AVLTree()
+{
+    this->clear();
+}
+
 /*
  * Recall: If key is already in the tree, you should 
  * overwrite the current value with the updated value.
  */
-template<class Key, class Value>
-void AVLTree<Key, Value>::insert (const std::pair<const Key, Value> &new_item)
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::insert (const std::pair<const Key, Value> &new_item)
 {
     // TODO
     AVLNode<Key, Value>* currentNode = static_cast<AVLNode<Key, Value>*>(this->root_); // sett current node at the root
     AVLNode<Key, Value>* parentNode = nullptr; // set the parent node to null for now 
+    AVLNode<Key, Value>* candidate = nullptr; // smallest key >= the new key seen so far
+    int dir = 0;
+    int depth = 0; // the new node's depth, for relaxed mode
 
-    while(currentNode != nullptr){ // traverse through the tree 
+    while(currentNode != nullptr){ // traverse through the tree, indexing the child by the compare instead of branching
       parentNode = currentNode; // remember the parent node 
-      if(new_item.first < currentNode->getKey()){ // if the key is smaller, go left
-        currentNode = currentNode->getLeft();
-      }
-      else if(new_item.first > currentNode->getKey()){ // if the key is larger, go right 
-        currentNode = currentNode->getRight();
-      }
-      else{ // otherwise the key already exists so just update the value 
-        currentNode->setValue(new_item.second); 
-        return;
+      ++depth;
+      dir = currentNode->getKey() < new_item.first;
+      candidate = dir ? candidate : currentNode;
+      currentNode = static_cast<AVLNode<Key, Value>*>(currentNode->getChild(dir));
+    }
+    if(candidate != nullptr && !(new_item.first < candidate->getKey())){ // the key already exists so just update the value 
+      candidate->setValue(new_item.second); 
+      if(candidate->isDead()){ // bring a tombstone back to life
+        candidate->setDead(false);
+        --dead_;
+        ++this->size_;
       }
+      this->augmentPath(candidate);
+      return;
     }
 
-    AVLNode<Key, Value>* newNode = new AVLNode<Key, Value>(new_item.first, new_item.second, parentNode); // create the new node to insert into
+    AVLNode<Key, Value>* newNode = createNode(new_item.first, new_item.second, parentNode); // create the new node to insert into
+    ++this->size_;
     if(parentNode == nullptr){ // new node becomes the root if the tree was empty
       this->root_ = newNode;
+      this->augmentPath(newNode);
       return;
     }
-    else if(new_item.first < parentNode->getKey()){ // if the key is less than the parent's key, then the node becomes a left child 
-      parentNode->setLeft(newNode);
-    }
-    else{ // if the key is greater than the parent's key, then the node becomes a right child 
-      parentNode->setRight(newNode);
+    parentNode->setChild(dir, newNode); // the node goes in the empty slot the descent ended on
+
+    if(relaxedBound_ > 1){ // no retrace; rebalance() sorts out the flagged path later
+      markPending(parentNode);
+      this->augmentPath(newNode);
+      int scaled = depth / relaxedBound_;
+      if(scaled >= 63 || ((size_t)1 << scaled) > this->size_){ // deeper than bound * log2(size)
+        rebalance();
+      }
+      return;
     }
 
     AVLNode<Key, Value>* node = newNode; // set node to start rebalancing from 
@@ -203,14 +391,15 @@ void AVLTree<Key, Value>::insert (const std::pair<const Key, Value> &new_item)
       node = parentNode; // move the node to the parent 
       parentNode = parentNode->getParent(); // reset the parent node 
     }
+    this->augmentPath(newNode); // rotations only fixed the nodes they moved off the path
 }
 
 /*
  * Recall: The writeup specifies that if a node has 2 children you
  * should swap with the predecessor and then remove.
  */
-template<class Key, class Value>
-void AVLTree<Key, Value>:: remove(const Key& key)
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>:: remove(const Key& key)
 {
     // TODO
     AVLNode<Key, Value>* node = static_cast<AVLNode<Key, Value>*>(this->internalFind(key)); // find the node to remove 
@@ -218,6 +407,17 @@ void AVLTree<Key, Value>:: remove(const Key& key)
       return;
     }
 
+    if(tombstoneMode_){ // just mark it, the shape is left alone until compaction
+      node->setDead(true);
+      --this->size_;
+      ++dead_;
+      this->augmentPath(node);
+      if(dead_ > compactThreshold_ * (this->size_ + dead_)){
+        compact();
+      }
+      return;
+    }
+
     if(node->getLeft() != nullptr && node->getRight() != nullptr){ // if the node has two children
       AVLNode<Key, Value>* predecessorNode = static_cast<AVLNode<Key, Value>*>(this->predecessor(node));
       this->nodeSwap(node, predecessorNode); // swap it with its predecessor 
@@ -250,7 +450,17 @@ void AVLTree<Key, Value>:: remove(const Key& key)
       }
     }
 
-    delete node; // delete the node 
+    this->destroyNode(node); // delete the node 
+    --this->size_;
+    AVLNode<Key, Value>* changedNode = parentNode; // lowest subtree that lost a node; the swapped-in predecessor is above it
+
+    if(relaxedBound_ > 1){ // no retrace; rebalance() sorts out the flagged path later
+      markPending(parentNode);
+      if(changedNode != nullptr){
+        this->augmentPath(changedNode);
+      }
+      return;
+    }
 
     AVLNode<Key, Value>* currentNode = parentNode; // set the current node for rebalancing 
     while(currentNode != nullptr){ // traverse through the tree 
@@ -270,15 +480,18 @@ void AVLTree<Key, Value>:: remove(const Key& key)
       }
       else if(balance == 2 || balance == -2){ // if it's unbalanced 
         AVLNode<Key, Value>* nextNode = currentNode->getParent();
+        AVLNode<Key, Value>* tallChild = (balance == 2) ? currentNode->getRight() : currentNode->getLeft();
+        bool heightKept = tallChild->getBalance() == 0; // a single rotation then leaves the height alone
         rebalanceHelper(currentNode); // rotations 
+        AVLNode<Key, Value>* subtreeTop = currentNode->getParent(); // what took currentNode's place
 
         currentNode = nextNode; // move the current node to the parent 
 
-        if(currentNode == nullptr){ // if we have reached the root do nothing 
+        if(currentNode == nullptr || heightKept){ // reached the root, or nothing above changed
           break;
         }
 
-        if(currentNode->getLeft() == node){ // if the node was removed from the left 
+        if(currentNode->getLeft() == subtreeTop){ // if the shorter subtree is on the left 
           removed = true;
         }
         else{
@@ -300,80 +513,563 @@ void AVLTree<Key, Value>:: remove(const Key& key)
         currentNode = nextNode; // move to the next node 
       }
     }
+    if(changedNode != nullptr){
+      this->augmentPath(changedNode);
+    }
 }
 
-template<class Key, class Value>
-void AVLTree<Key, Value>::nodeSwap( AVLNode<Key,Value>* n1, AVLNode<Key,Value>* n2)
+/**
+* Removes every item with lo <= key <= hi and returns how many there were,
+* in O(log n + k): split the tree into the parts below, inside and above
+* the range, join the outer two around the largest key below lo, and free
+* the middle part in one sweep. Joins are done by height, so the result is
+* a proper AVL tree, and every relinked node is augmented on the way.
+* Tombstones inside the range are freed too.
+*/
+template<class Key, class Value, class Alloc>
+size_t AVLTree<Key, Value, Alloc>::eraseRange(const Key& lo, const Key& hi)
+{
+    if(this->root_ == nullptr || hi < lo){
+      return 0;
+    }
+    rebalance(); // split and join expect AVL trees
+    AVLNode<Key, Value>* root = static_cast<AVLNode<Key, Value>*>(this->root_);
+    AVLNode<Key, Value>* below;
+    AVLNode<Key, Value>* rest;
+    AVLNode<Key, Value>* range;
+    AVLNode<Key, Value>* above;
+    int belowHeight, restHeight, rangeHeight, aboveHeight;
+    splitNodes(root, subtreeHeight(root), lo, false, below, belowHeight, rest, restHeight);
+    splitNodes(rest, restHeight, hi, true, range, rangeHeight, above, aboveHeight);
+
+    int height = aboveHeight;
+    AVLNode<Key, Value>* top = above;
+    if(below != nullptr){
+      AVLNode<Key, Value>* last = popLast(below, belowHeight, below, belowHeight);
+      top = joinNodes(below, belowHeight, last, above, aboveHeight, height);
+    }
+    this->root_ = top;
+    if(top != nullptr){
+      top->setParent(nullptr);
+    }
+
+    size_t deadInRange = 0;
+    if(dead_ != 0 && range != nullptr){ // count tombstones before the sweep frees them
+      range->setParent(nullptr);
+      Node<Key, Value>* node = range;
+      while(node->getLeft() != nullptr){
+        node = node->getLeft();
+      }
+      for(; node != nullptr; node = BinarySearchTree<Key, Value, Alloc>::successor(node)){
+        if(static_cast<AVLNode<Key, Value>*>(node)->isDead()){
+          ++deadInRange;
+        }
+      }
+    }
+    size_t removed = this->destroySubtree(range) - deadInRange;
+    dead_ -= deadInRange;
+    this->size_ -= removed;
+    return removed;
+}
+
+/**
+* Height of a subtree in O(log n), following the taller child down.
+*/
+template<class Key, class Value, class Alloc>
+int AVLTree<Key, Value, Alloc>::subtreeHeight(AVLNode<Key, Value>* node)
+{
+    int height = 0;
+    while(node != nullptr){
+      ++height;
+      node = node->getBalance() > 0 ? node->getRight() : node->getLeft();
+    }
+    return height;
+}
+
+/**
+* The children's heights, from node's height and balance.
+*/
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::childHeights(AVLNode<Key, Value>* node, int height, int& leftHeight, int& rightHeight)
+{
+    int balance = node->getBalance(); // may be +-2 mid-join
+    leftHeight = balance <= 0 ? height - 1 : height - 1 - balance;
+    rightHeight = balance >= 0 ? height - 1 : height - 1 + balance;
+}
+
+/**
+* Makes left and right node's children, fixing parents, the balance and
+* node's augmented data. The heights must differ by at most two; callers
+* rotate away a difference of two right after.
+*/
+template<class Key, class Value, class Alloc>
+AVLNode<Key, Value>* AVLTree<Key, Value, Alloc>::linkNode(AVLNode<Key, Value>* left, int leftHeight, AVLNode<Key, Value>* node,
+                                                          AVLNode<Key, Value>* right, int rightHeight, int& height)
+{
+    node->setLeft(left);
+    node->setRight(right);
+    if(left != nullptr) left->setParent(node);
+    if(right != nullptr) right->setParent(node);
+    node->setBalance((int8_t)(rightHeight - leftHeight));
+    node->setPending(false); // both sides are strict AVL trees wherever this is used
+    this->augmentNode(node);
+    height = (leftHeight > rightHeight ? leftHeight : rightHeight) + 1;
+    return node;
+}
+
+template<class Key, class Value, class Alloc>
+AVLNode<Key, Value>* AVLTree<Key, Value, Alloc>::rotateLinkedLeft(AVLNode<Key, Value>* node, int height, int& newHeight)
+{
+    int leftHeight, rightHeight, innerHeight, outerHeight, lowHeight;
+    childHeights(node, height, leftHeight, rightHeight);
+    AVLNode<Key, Value>* pivot = node->getRight();
+    childHeights(pivot, rightHeight, innerHeight, outerHeight);
+    AVLNode<Key, Value>* outer = pivot->getRight();
+    AVLNode<Key, Value>* low = linkNode(node->getLeft(), leftHeight, node, pivot->getLeft(), innerHeight, lowHeight);
+    return linkNode(low, lowHeight, pivot, outer, outerHeight, newHeight);
+}
+
+template<class Key, class Value, class Alloc>
+AVLNode<Key, Value>* AVLTree<Key, Value, Alloc>::rotateLinkedRight(AVLNode<Key, Value>* node, int height, int& newHeight)
+{
+    int leftHeight, rightHeight, outerHeight, innerHeight, lowHeight;
+    childHeights(node, height, leftHeight, rightHeight);
+    AVLNode<Key, Value>* pivot = node->getLeft();
+    childHeights(pivot, leftHeight, outerHeight, innerHeight);
+    AVLNode<Key, Value>* outer = pivot->getLeft();
+    AVLNode<Key, Value>* low = linkNode(pivot->getRight(), innerHeight, node, node->getRight(), rightHeight, lowHeight);
+    return linkNode(outer, outerHeight, pivot, low, lowHeight, newHeight);
+}
+
+/**
+* Joins left, node and right, where every key in left is below node's and
+* every key in right above it, into one AVL tree in O(|leftHeight -
+* rightHeight| + 1): the shorter tree is hung off the taller one's spine at
+* the matching height and the spine is rebalanced on the way back up.
+*/
+template<class Key, class Value, class Alloc>
+AVLNode<Key, Value>* AVLTree<Key, Value, Alloc>::joinNodes(AVLNode<Key, Value>* left, int leftHeight, AVLNode<Key, Value>* node,
+                                                           AVLNode<Key, Value>* right, int rightHeight, int& height)
+{
+    if(leftHeight > rightHeight + 1){
+      return joinRight(left, leftHeight, node, right, rightHeight, height);
+    }
+    if(rightHeight > leftHeight + 1){
+      return joinLeft(left, leftHeight, node, right, rightHeight, height);
+    }
+    return linkNode(left, leftHeight, node, right, rightHeight, height);
+}
+
+template<class Key, class Value, class Alloc>
+AVLNode<Key, Value>* AVLTree<Key, Value, Alloc>::joinRight(AVLNode<Key, Value>* left, int leftHeight, AVLNode<Key, Value>* node,
+                                                           AVLNode<Key, Value>* right, int rightHeight, int& height)
+{
+    int outerHeight, innerHeight, joinedHeight;
+    childHeights(left, leftHeight, outerHeight, innerHeight);
+    AVLNode<Key, Value>* outer = left->getLeft();
+    AVLNode<Key, Value>* joined;
+    if(innerHeight <= rightHeight + 1){ // found the spot on the right spine
+      joined = linkNode(left->getRight(), innerHeight, node, right, rightHeight, joinedHeight);
+      if(joinedHeight <= outerHeight + 1){
+        return linkNode(outer, outerHeight, left, joined, joinedHeight, height);
+      }
+      joined = rotateLinkedRight(joined, joinedHeight, joinedHeight); // double rotation
+      AVLNode<Key, Value>* top = linkNode(outer, outerHeight, left, joined, joinedHeight, joinedHeight);
+      return rotateLinkedLeft(top, joinedHeight, height);
+    }
+    joined = joinRight(left->getRight(), innerHeight, node, right, rightHeight, joinedHeight);
+    AVLNode<Key, Value>* top = linkNode(outer, outerHeight, left, joined, joinedHeight, height);
+    if(joinedHeight <= outerHeight + 1){
+      return top;
+    }
+    return rotateLinkedLeft(top, height, height);
+}
+
+template<class Key, class Value, class Alloc>
+AVLNode<Key, Value>* AVLTree<Key, Value, Alloc>::joinLeft(AVLNode<Key, Value>* left, int leftHeight, AVLNode<Key, Value>* node,
+                                                          AVLNode<Key, Value>* right, int rightHeight, int& height)
+{
+    int innerHeight, outerHeight, joinedHeight;
+    childHeights(right, rightHeight, innerHeight, outerHeight);
+    AVLNode<Key, Value>* outer = right->getRight();
+    AVLNode<Key, Value>* joined;
+    if(innerHeight <= leftHeight + 1){ // found the spot on the left spine
+      joined = linkNode(left, leftHeight, node, right->getLeft(), innerHeight, joinedHeight);
+      if(joinedHeight <= outerHeight + 1){
+        return linkNode(joined, joinedHeight, right, outer, outerHeight, height);
+      }
+      joined = rotateLinkedLeft(joined, joinedHeight, joinedHeight); // double rotation
+      AVLNode<Key, Value>* top = linkNode(joined, joinedHeight, right, outer, outerHeight, joinedHeight);
+      return rotateLinkedRight(top, joinedHeight, height);
+    }
+    joined = joinLeft(left, leftHeight, node, right->getLeft(), innerHeight, joinedHeight);
+    AVLNode<Key, Value>* top = linkNode(joined, joinedHeight, right, outer, outerHeight, height);
+    if(joinedHeight <= outerHeight + 1){
+      return top;
+    }
+    return rotateLinkedRight(top, height, height);
+}
+
+/**
+* Splits the subtree at node into left (keys below key, plus key itself if
+* equalGoesLeft) and right, both valid AVL trees. Every node on the search
+* path is joined back into one side; the joins' costs telescope to O(log n).
+*/
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::splitNodes(AVLNode<Key, Value>* node, int height, const Key& key, bool equalGoesLeft,
+                                            AVLNode<Key, Value>*& left, int& leftHeight, AVLNode<Key, Value>*& right, int& rightHeight)
+{
+    if(node == nullptr){
+      left = right = nullptr;
+      leftHeight = rightHeight = 0;
+      return;
+    }
+    int childLeftHeight, childRightHeight;
+    childHeights(node, height, childLeftHeight, childRightHeight);
+    AVLNode<Key, Value>* childLeft = node->getLeft();
+    AVLNode<Key, Value>* childRight = node->getRight();
+    if(node->getKey() < key || (equalGoesLeft && !(key < node->getKey()))){ // node goes left
+      AVLNode<Key, Value>* middle;
+      int middleHeight;
+      splitNodes(childRight, childRightHeight, key, equalGoesLeft, middle, middleHeight, right, rightHeight);
+      left = joinNodes(childLeft, childLeftHeight, node, middle, middleHeight, leftHeight);
+    }
+    else{
+      AVLNode<Key, Value>* middle;
+      int middleHeight;
+      splitNodes(childLeft, childLeftHeight, key, equalGoesLeft, left, leftHeight, middle, middleHeight);
+      right = joinNodes(middle, middleHeight, node, childRight, childRightHeight, rightHeight);
+    }
+}
+
+/**
+* Detaches and returns the largest node of the subtree at node; rest is
+* what remains, rebalanced.
+*/
+template<class Key, class Value, class Alloc>
+AVLNode<Key, Value>* AVLTree<Key, Value, Alloc>::popLast(AVLNode<Key, Value>* node, int height,
+                                                         AVLNode<Key, Value>*& rest, int& restHeight)
+{
+    int leftHeight, rightHeight;
+    childHeights(node, height, leftHeight, rightHeight);
+    if(node->getRight() == nullptr){
+      rest = node->getLeft();
+      restHeight = leftHeight;
+      return node;
+    }
+    AVLNode<Key, Value>* left = node->getLeft();
+    AVLNode<Key, Value>* remaining;
+    int remainingHeight;
+    AVLNode<Key, Value>* last = popLast(node->getRight(), rightHeight, remaining, remainingHeight);
+    rest = joinNodes(left, leftHeight, node, remaining, remainingHeight, restHeight);
+    return last;
+}
+
+/**
+* Removes everything, tombstones included.
+*/
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::clear()
+{
+    BinarySearchTree<Key, Value, Alloc>::clear();
+    dead_ = 0;
+}
+
+/**
+* AVLTree does its own rebalancing and never consults the scapegoat
+* counters, so only 0 (off) is accepted.
+*/
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::setScapegoatAlpha(double alpha)
+{
+    if(alpha != 0){
+      throw std::invalid_argument("AVLTree keeps its own balance; scapegoat mode is not supported");
+    }
+}
+
+/**
+* Turns lazy deletion on or off. While on, remove() only marks the node dead
+* (O(log n) to find, no rotations) and lookups and iterators skip it; once
+* dead nodes make up more than compactThreshold of the tree, compact() runs.
+* A threshold of 1 leaves compaction entirely to the caller, e.g. at idle
+* times. Turning the mode off compacts right away.
+*/
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::setTombstones(bool enabled, double compactThreshold)
+{
+    if(compactThreshold <= 0 || compactThreshold > 1){
+      throw std::invalid_argument("compaction threshold must be in (0, 1]");
+    }
+    tombstoneMode_ = enabled;
+    compactThreshold_ = compactThreshold;
+    if(!enabled){
+      compact();
+    }
+}
+
+/**
+* Relaxed balance for write bursts: with bound > 1, insert and remove do
+* no retrace and no rotations. They only flag the changed node's ancestors
+* as pending, stopping at the first one already flagged, so a burst
+* touching one region does O(1) work above each insertion point. Balance
+* factors inside the flagged part go stale; rebalance() (call it at a
+* quiescent point, e.g. between bursts) recomputes heights and repairs just
+* that part. An insert that lands deeper than bound * log2(size) runs
+* rebalance() itself, which keeps the height within that. The tree runs no
+* thread of its own; the owner schedules rebalance() like any other write.
+* bound must be in [1, 100]; 1 is the usual eager AVL tree and restores
+* strict balance right away. isBalanced() is only true again after a
+* rebalance().
+*/
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::setRelaxedBalance(int bound)
+{
+    if(bound < 1 || bound > 100){
+      throw std::invalid_argument("relaxed balance bound must be in [1, 100]");
+    }
+    relaxedBound_ = bound;
+    if(bound == 1){
+      rebalance();
+    }
+}
+
+template<class Key, class Value, class Alloc>
+int AVLTree<Key, Value, Alloc>::relaxedBalance() const
+{
+    return relaxedBound_;
+}
+
+/**
+* Restores strict AVL balance after relaxed-mode writes. Only flagged
+* nodes are visited, bottom up: once both children are AVL trees, the
+* node is put back together with joinNodes in O(height difference). An
+* unflagged child's height is read off its exact balances, so the pass is
+* O(p log n) for p flagged nodes. Free when nothing is pending.
+*/
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::rebalance()
+{
+    AVLNode<Key, Value>* root = static_cast<AVLNode<Key, Value>*>(this->root_);
+    if(root == nullptr || !root->isPending()){
+      return;
+    }
+    int height;
+    root = repairSubtree(root, height);
+    root->setParent(nullptr);
+    this->root_ = root;
+}
+
+/**
+* Frees every dead node and relinks the live ones into a perfectly balanced
+* tree in O(n). Iterators are invalidated.
+*/
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::compact()
+{
+    if(dead_ == 0){
+      return;
+    }
+
+    std::vector<Node<Key, Value>*> live;
+    std::vector<Node<Key, Value>*> dead;
+    live.reserve(this->size_);
+    dead.reserve(dead_);
+    Node<Key, Value>* current = this->getSmallestNode();
+    while(current != nullptr){ // nodes can only be freed once the walk is done
+      if(static_cast<AVLNode<Key, Value>*>(current)->isDead()){
+        dead.push_back(current);
+      }
+      else{
+        live.push_back(current);
+      }
+      current = BinarySearchTree<Key, Value, Alloc>::successor(current);
+    }
+
+    int height;
+    this->root_ = this->buildBalanced(live, 0, (int)live.size() - 1, nullptr, height);
+    for(size_t i = 0; i < dead.size(); ++i){
+      this->destroyNode(dead[i]);
+    }
+    dead_ = 0;
+}
+
+/**
+* Replaces the contents with the (key, value) pairs in [first, last), whose
+* keys must be strictly increasing, in O(n): the nodes are allocated in
+* order and linked into a perfectly balanced tree, with no comparisons or
+* rotations. Throws std::invalid_argument, leaving the tree empty, if the
+* keys are out of order.
+*
+* Each node is created with the previous one as its parent, which is where
+* an in-order insert would put it, so trees that thread or otherwise link
+* new nodes through createNode see the usual order.
+*/
+template<class Key, class Value, class Alloc>
+template<typename InputIt>
+void AVLTree<Key, Value, Alloc>::assignSorted(InputIt first, InputIt last)
+{
+    clear();
+    std::vector<Node<Key, Value>*> nodes;
+    AVLNode<Key, Value>* previous = nullptr;
+    try{
+      for(; first != last; ++first){
+        if(previous != nullptr && !(previous->getKey() < first->first)){
+          throw std::invalid_argument("assignSorted: keys must be strictly increasing");
+        }
+        nodes.push_back(nullptr); // grow first so a throw here leaks nothing
+        previous = createNode(first->first, first->second, previous);
+        nodes.back() = previous;
+      }
+    }
+    catch(...){
+      for(size_t i = 0; i < nodes.size(); ++i){
+        if(nodes[i] != nullptr) this->destroyNode(nodes[i]);
+      }
+      throw;
+    }
+
+    int height;
+    this->root_ = this->buildBalanced(nodes, 0, (int)nodes.size() - 1, nullptr, height);
+    this->size_ = nodes.size();
+    if(this->maxSize_ < this->size_) this->maxSize_ = this->size_;
+}
+
+/**
+* Number of dead nodes waiting for compaction.
+*/
+template<class Key, class Value, class Alloc>
+size_t AVLTree<Key, Value, Alloc>::tombstones() const
 {
-    BinarySearchTree<Key, Value>::nodeSwap(n1, n2);
+    return dead_;
+}
+
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::nodeSwap( AVLNode<Key,Value>* n1, AVLNode<Key,Value>* n2)
+{
+    BinarySearchTree<Key, Value, Alloc>::nodeSwap(n1, n2);
     int8_t tempB = n1->getBalance();
     n1->setBalance(n2->getBalance());
     n2->setBalance(tempB);
+    bool tempPending = n1->isPending(); // the flag belongs to the position, like the balance
+    n1->setPending(n2->isPending());
+    n2->setPending(tempPending);
 }
 
-// adding my rotation helper functions
-template<class Key, class Value>
-void AVLTree<Key, Value>::leftRotation(AVLNode<Key, Value>* node)
+/**
+* Allocates the node for a new key; parent is where it will hang. Trees that
+* need a bigger node type override this.
+*/
+template<class Key, class Value, class Alloc>
+AVLNode<Key, Value>* AVLTree<Key, Value, Alloc>::createNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent)
 {
-  AVLNode<Key, Value>* rightChild = node->getRight(); // get the right child of the node 
-  if(!rightChild){ // if it doesn't exist then do nothing 
-    return;
-  }
+    return this->template allocateNode<AVLNode<Key, Value> >(key, value, parent);
+}
 
-  AVLNode<Key, Value>* parentNode = node->getParent();
-  node->setRight(rightChild->getLeft()); // reset the right pointer 
+/**
+* Like the base version, but a dead node counts as missing.
+*/
+template<class Key, class Value, class Alloc>
+Node<Key, Value>* AVLTree<Key, Value, Alloc>::internalFind(const Key& key) const
+{
+    Node<Key, Value>* node = BinarySearchTree<Key, Value, Alloc>::internalFind(key);
+    if(node != nullptr && dead_ != 0 && static_cast<AVLNode<Key, Value>*>(node)->isDead()){
+      return nullptr;
+    }
+    return node;
+}
 
-  if(rightChild->getLeft()){ // if there is a subtree then also reset its parent 
-    rightChild->getLeft()->setParent(node);
-  }
+template<class Key, class Value, class Alloc>
+Node<Key, Value>* AVLTree<Key, Value, Alloc>::nextNode(Node<Key, Value>* current) const
+{
+    return firstVisible(BinarySearchTree<Key, Value, Alloc>::successor(current));
+}
 
-  rightChild->setLeft(node); // resetting node pointers 
-  node->setParent(rightChild);
-  rightChild->setParent(parentNode);
+template<class Key, class Value, class Alloc>
+Node<Key, Value>* AVLTree<Key, Value, Alloc>::prevNode(Node<Key, Value>* current) const
+{
+    return lastVisible(BinarySearchTree<Key, Value, Alloc>::predecessor(current));
+}
 
-  if(parentNode == nullptr){ // if the node was the root then reset the root 
-    this->root_ = rightChild;
-  }
-  else if(parentNode->getLeft() == node){ // node was left child 
-    parentNode->setLeft(rightChild);
-  }
-  else{ // node was right child 
-    parentNode->setRight(rightChild); 
-  }
+/**
+* Steps forward past dead nodes; free when there are none.
+*/
+template<class Key, class Value, class Alloc>
+Node<Key, Value>* AVLTree<Key, Value, Alloc>::firstVisible(Node<Key, Value>* node) const
+{
+    if(dead_ == 0){
+      return node;
+    }
+    while(node != nullptr && static_cast<AVLNode<Key, Value>*>(node)->isDead()){
+      node = BinarySearchTree<Key, Value, Alloc>::successor(node);
+    }
+    return node;
 }
 
-template<class Key, class Value>
-void AVLTree<Key, Value>::rightRotation(AVLNode<Key, Value>* node)
+template<class Key, class Value, class Alloc>
+Node<Key, Value>* AVLTree<Key, Value, Alloc>::lastVisible(Node<Key, Value>* node) const
 {
-  AVLNode<Key, Value>* leftChild = node->getLeft(); // get the left child of the node 
-  if(!leftChild){ // do nothing if it doesn't exist 
-    return;
-  }
+    if(dead_ == 0){
+      return node;
+    }
+    while(node != nullptr && static_cast<AVLNode<Key, Value>*>(node)->isDead()){
+      node = BinarySearchTree<Key, Value, Alloc>::predecessor(node);
+    }
+    return node;
+}
 
-  AVLNode<Key, Value>* parentNode = node->getParent();
-  node->setLeft(leftChild->getRight());// reset the left pointer 
+/**
+* Dead nodes are hidden.
+*/
+template<class Key, class Value, class Alloc>
+bool AVLTree<Key, Value, Alloc>::isVisible(Node<Key, Value>* node) const
+{
+    return !static_cast<AVLNode<Key, Value>*>(node)->isDead();
+}
 
-  if(leftChild->getRight()){ // if there is a subtree then also reset its parent 
-    leftChild->getRight()->setParent(node);
-  }
+/**
+* Rebuilt subtrees are perfectly balanced, so the balance is just the
+* difference of the two heights.
+*/
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::rebuiltNode(Node<Key, Value>* node, int leftHeight, int rightHeight)
+{
+    static_cast<AVLNode<Key, Value>*>(node)->setBalance((int8_t)(rightHeight - leftHeight));
+    static_cast<AVLNode<Key, Value>*>(node)->setPending(false);
+}
 
-  leftChild->setRight(node); // resetting node pointers 
-  node->setParent(leftChild);
-  leftChild->setParent(parentNode);
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::swapTree(BinarySearchTree<Key, Value, Alloc>& other)
+{
+    BinarySearchTree<Key, Value, Alloc>::swapTree(other);
+    AVLTree<Key, Value, Alloc>& otherTree = static_cast<AVLTree<Key, Value, Alloc>&>(other);
+    std::swap(tombstoneMode_, otherTree.tombstoneMode_);
+    std::swap(compactThreshold_, otherTree.compactThreshold_);
+    std::swap(dead_, otherTree.dead_);
+    std::swap(relaxedBound_, otherTree.relaxedBound_);
+}
 
-  if(parentNode == nullptr){ // if the node was the root then reset the root 
-    this->root_ = leftChild;
-  }
-  else if(parentNode->getLeft() == node){ // if the node was a left child 
-    parentNode->setLeft(leftChild);
-  }
-  else{ // if the node was a right child 
-    parentNode->setRight(leftChild);
-  }
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::destroyNode(Node<Key, Value>* node)
+{
+    this->deallocateNode(static_cast<AVLNode<Key, Value>*>(node));
 }
 
-template<class Key, class Value>
-void AVLTree<Key, Value>::rebalanceHelper(AVLNode<Key, Value>* node)
+// adding my rotation helper functions
+// the pointer surgery lives in BinarySearchTree so other trees can share it
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::leftRotation(AVLNode<Key, Value>* node)
+{
+  this->rotateLeft(node);
+}
+
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::rightRotation(AVLNode<Key, Value>* node)
+{
+  this->rotateRight(node);
+}
+
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::rebalanceHelper(AVLNode<Key, Value>* node)
 {
   int8_t balance = node->getBalance(); // get the current balance 
 
@@ -383,9 +1079,10 @@ void AVLTree<Key, Value>::rebalanceHelper(AVLNode<Key, Value>* node)
       return;
     }
     if(left->getBalance() <= 0){ // left left zig zig case 
+      bool even = left->getBalance() == 0; // only after a remove
       rightRotation(node); // perform one rotation
-      node->setBalance(0); // reset the balances after rotating 
-      left->setBalance(0);
+      node->setBalance(even ? -1 : 0); // reset the balances after rotating 
+      left->setBalance(even ? 1 : 0);
     }
     else{ // left right zig zag case 
       AVLNode<Key, Value>* grandchild = left->getRight(); // get the grandchild node 
@@ -416,9 +1113,10 @@ void AVLTree<Key, Value>::rebalanceHelper(AVLNode<Key, Value>* node)
     }
 
     if(right->getBalance() >= 0){ // right right zig zig case 
+      bool even = right->getBalance() == 0; // only after a remove
       leftRotation(node); // perform one rotation 
-      node->setBalance(0); // reset the balances 
-      right->setBalance(0);
+      node->setBalance(even ? 1 : 0); // reset the balances 
+      right->setBalance(even ? -1 : 0);
     }
     else{ // right left zig zag case 
       AVLNode<Key, Value>* grandchild = right->getLeft(); // get the grandchild 
@@ -444,5 +1142,37 @@ void AVLTree<Key, Value>::rebalanceHelper(AVLNode<Key, Value>* node)
   }
 }
 
+/**
+* Flags node and its ancestors; stops at the first one already flagged,
+* since its ancestors are too.
+*/
+template<class Key, class Value, class Alloc>
+void AVLTree<Key, Value, Alloc>::markPending(AVLNode<Key, Value>* node)
+{
+    while(node != nullptr && !node->isPending()){
+      node->setPending(true);
+      node = node->getParent();
+    }
+}
+
+/**
+* Returns the subtree at node as a strict AVL tree and sets height to its
+* height. Unflagged subtrees are already strict and are returned as they
+* are; a flagged node's own balance is stale and is ignored. The caller
+* links the result to its parent.
+*/
+template<class Key, class Value, class Alloc>
+AVLNode<Key, Value>* AVLTree<Key, Value, Alloc>::repairSubtree(AVLNode<Key, Value>* node, int& height)
+{
+    if(node == nullptr || !node->isPending()){
+      height = subtreeHeight(node);
+      return node;
+    }
+    int leftHeight, rightHeight;
+    AVLNode<Key, Value>* left = repairSubtree(node->getLeft(), leftHeight);
+    AVLNode<Key, Value>* right = repairSubtree(node->getRight(), rightHeight);
+    return joinNodes(left, leftHeight, node, right, rightHeight, height); // clears the flag via linkNode
+}
+
 
 #endif
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include "bst.h"
+#include "avlbst.h"
+
+using namespace std;
+
+// Random lookups on a large AVLTree, one find() at a time against
+// findBatch() over batches of 16 to 256 keys. Half the probes miss.
+//
+// usage: bench-batch [num_keys] [num_lookups]
+
+int main(int argc, char *argv[])
+{
+    int numKeys = (argc > 1) ? atoi(argv[1]) : 4000000;
+    int numLookups = (argc > 2) ? atoi(argv[2]) : 4000000;
+
+    mt19937 rng(104);
+    vector<int> keys(numKeys);
+    for(int i = 0; i < numKeys; ++i){
+      keys[i] = 2 * i;
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+    AVLTree<int, int> tree;
+    for(int i = 0; i < numKeys; ++i){
+      tree.insert(make_pair(keys[i], keys[i]));
+    }
+    vector<int> probes(numLookups);
+    for(int i = 0; i < numLookups; ++i){
+      probes[i] = rng() % (2 * numKeys);
+    }
+
+    cout << "keys: " << numKeys << "  lookups: " << numLookups << endl;
+
+    long long expected = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(int i = 0; i < numLookups; ++i){
+      AVLTree<int, int>::iterator it = tree.find(probes[i]);
+      if(it != tree.end()){
+        expected += it->second;
+      }
+    }
+    chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+    cout << "find one at a time:   " << chrono::duration<double, nano>(stop - start).count() / numLookups << " ns/lookup" << endl;
+
+    const size_t batchSizes[] = { 16, 64, 256 };
+    for(size_t b = 0; b < sizeof(batchSizes) / sizeof(batchSizes[0]); ++b){
+      size_t batch = batchSizes[b];
+      vector<AVLTree<int, int>::iterator> out(batch);
+      long long sum = 0;
+      start = chrono::steady_clock::now();
+      for(size_t i = 0; i < (size_t)numLookups; i += batch){
+        size_t count = min(batch, numLookups - i);
+        tree.findBatch(&probes[i], count, &out[0]);
+        for(size_t j = 0; j < count; ++j){
+          if(out[j] != tree.end()){
+            sum += out[j]->second;
+          }
+        }
+      }
+      stop = chrono::steady_clock::now();
+      cout << "findBatch, batch " << batch << ":  " << chrono::duration<double, nano>(stop - start).count() / numLookups
+           << " ns/lookup" << (sum != expected ? "  checksum mismatch!" : "") << endl;
+    }
+    return 0;
+}
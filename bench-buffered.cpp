@@ -0,0 +1,77 @@
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <chrono>
+#include "bst.h"
+#include "avlbst.h"
+#include "bufferedbst.h"
+
+using namespace std;
+
+// Insert bursts into a prefilled AVLTree through a BufferedTree. Bursts
+// come in three shapes: uniformly random keys, keys clustered in a narrow
+// range, and repeated updates to a handful of hot keys.
+//
+// Node placement depends heavily on what the heap saw before, so each
+// buffer size is measured in its own run with the same history; compare
+// e.g. "bench-buffered 0" (plain AVLTree inserts) with "bench-buffered 64".
+//
+// usage: bench-buffered [buffer_size] [num_keys] [num_inserts]
+
+const int BURST = 1024;
+
+template<typename Tree>
+double timeInserts(Tree& tree, const vector<int>& prefill, const vector<int>& keys)
+{
+    for(size_t i = 0; i < prefill.size(); ++i){
+      tree.insert(make_pair(prefill[i], prefill[i]));
+    }
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(size_t i = 0; i < keys.size(); ++i){
+      tree.insert(make_pair(keys[i], (int)i));
+    }
+    chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(stop - start).count() / keys.size();
+}
+
+double timeBuffered(size_t bufferSize, const vector<int>& prefill, const vector<int>& keys)
+{
+    BufferedTree<int, int> tree(bufferSize);
+    double ns = timeInserts(tree, prefill, keys);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    tree.flush(); // the last partial batch counts too
+    chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+    return ns + chrono::duration<double, nano>(stop - start).count() / keys.size();
+}
+
+int main(int argc, char *argv[])
+{
+    size_t bufferSize = (argc > 1) ? atoi(argv[1]) : 64;
+    int numKeys = (argc > 2) ? atoi(argv[2]) : 1000000;
+    int numInserts = (argc > 3) ? atoi(argv[3]) : 1000000;
+    const int keySpace = 1 << 30;
+
+    mt19937 rng(104);
+    vector<int> prefill(numKeys);
+    for(int i = 0; i < numKeys; ++i){
+      prefill[i] = rng() % keySpace;
+    }
+
+    const char* names[] = { "random   ", "clustered", "hot keys " };
+    cout << "keys: " << numKeys << "  inserts: " << numInserts << "  burst: " << BURST
+         << "  buffer: " << bufferSize << endl;
+    for(int shape = 0; shape < 3; ++shape){
+      vector<int> keys(numInserts);
+      for(int i = 0; i < numInserts; i += BURST){
+        int base = rng() % keySpace;
+        for(int j = i; j < i + BURST && j < numInserts; ++j){
+          if(shape == 0) keys[j] = rng() % keySpace;
+          else if(shape == 1) keys[j] = base + rng() % (64 * BURST);
+          else keys[j] = base + rng() % 32;
+        }
+      }
+      cout << names[shape] << "  " << timeBuffered(bufferSize, prefill, keys) << " ns/insert" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include "bst.h"
+#include "avlbst.h"
+
+using namespace std;
+
+// Random insert and lookup throughput, the case where the left/right
+// decision on each level is a coin flip the branch predictor cannot learn.
+// Half the probes miss. std::map is the reference, and an AVLTree with the
+// hash index on shows what skipping the descent altogether buys.
+//
+// usage: bench-descent [num_keys] [num_probes]
+
+typedef chrono::steady_clock::time_point TimePoint;
+
+double nsPer(TimePoint start, TimePoint stop, size_t count)
+{
+    return chrono::duration<double, nano>(stop - start).count() / count;
+}
+
+struct IndexedAVLTree : public AVLTree<int, int> {
+    IndexedAVLTree() { enableHashIndex(); }
+};
+
+template<typename Tree>
+bool contains(const Tree& tree, int key)
+{
+    return tree.find(key) != tree.end();
+}
+
+template<typename Tree>
+void runLookups(const char* name, const vector<int>& keys, const vector<int>& probes)
+{
+    Tree tree;
+    long long hits = 0;
+
+    TimePoint t0 = chrono::steady_clock::now();
+    for(size_t i = 0; i < keys.size(); ++i){
+      tree.insert(make_pair(keys[i], keys[i]));
+    }
+    TimePoint t1 = chrono::steady_clock::now();
+    for(size_t i = 0; i < probes.size(); ++i){
+      hits += contains(tree, probes[i]);
+    }
+    TimePoint t2 = chrono::steady_clock::now();
+
+    cout << name << "insert " << nsPer(t0, t1, keys.size()) << "  find " << nsPer(t1, t2, probes.size())
+         << " ns/op  hits " << hits << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    int numKeys = (argc > 1) ? atoi(argv[1]) : 1000000;
+    int numProbes = (argc > 2) ? atoi(argv[2]) : 4000000;
+
+    mt19937 rng(104);
+    vector<int> keys(numKeys);
+    for(int i = 0; i < numKeys; ++i){
+      keys[i] = 2 * i; // odd probes miss
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+    vector<int> probes(numProbes);
+    for(int i = 0; i < numProbes; ++i){
+      probes[i] = rng() % (2 * numKeys);
+    }
+
+    cout << "keys: " << numKeys << "  probes: " << numProbes << endl;
+    runLookups<BinarySearchTree<int, int> >("BinarySearchTree: ", keys, probes);
+    runLookups<AVLTree<int, int> >("AVLTree:          ", keys, probes);
+    runLookups<IndexedAVLTree>("AVLTree + index:  ", keys, probes);
+    runLookups<map<int, int> >("std::map:         ", keys, probes);
+    return 0;
+}
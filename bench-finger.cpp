@@ -0,0 +1,68 @@
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include "bst.h"
+#include "avlbst.h"
+
+using namespace std;
+
+// find() throughput of an AVLTree with and without finger search, on
+// lookups of adjacent keys, a random walk with small steps and uniformly
+// random keys (where the finger can only cost).
+//
+// usage: bench-finger [num_keys] [num_probes]
+
+typedef chrono::steady_clock::time_point TimePoint;
+
+double nsPerFind(AVLTree<int, int>& tree, const vector<int>& probes, long long& hits)
+{
+    TimePoint start = chrono::steady_clock::now();
+    for(size_t i = 0; i < probes.size(); ++i){
+      hits += (tree.find(probes[i]) != tree.end());
+    }
+    TimePoint stop = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(stop - start).count() / probes.size();
+}
+
+int main(int argc, char *argv[])
+{
+    int numKeys = (argc > 1) ? atoi(argv[1]) : 1000000;
+    int numProbes = (argc > 2) ? atoi(argv[2]) : 4000000;
+
+    mt19937 rng(104);
+    vector<int> keys(numKeys);
+    for(int i = 0; i < numKeys; ++i){
+      keys[i] = i;
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+    AVLTree<int, int> tree;
+    for(int i = 0; i < numKeys; ++i){
+      tree.insert(make_pair(keys[i], keys[i]));
+    }
+
+    vector<int> adjacent(numProbes), walk(numProbes), random(numProbes);
+    int position = numKeys / 2;
+    for(int i = 0; i < numProbes; ++i){
+      adjacent[i] = i % numKeys;
+      position = (position + (int)(rng() % 33) - 16 + numKeys) % numKeys;
+      walk[i] = position;
+      random[i] = rng() % numKeys;
+    }
+
+    const char* names[3] = { "adjacent", "walk +-16", "random   " };
+    const vector<int>* patterns[3] = { &adjacent, &walk, &random };
+    long long hits = 0;
+    cout << "keys: " << numKeys << "  probes: " << numProbes << endl;
+    for(int p = 0; p < 3; ++p){
+      tree.setFingerSearch(false);
+      double plain = nsPerFind(tree, *patterns[p], hits);
+      tree.setFingerSearch(true);
+      double finger = nsPerFind(tree, *patterns[p], hits);
+      cout << names[p] << "  root " << plain << "  finger " << finger << " ns/find" << endl;
+    }
+    cout << "hits " << hits << endl;
+    return 0;
+}
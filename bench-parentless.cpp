@@ -0,0 +1,77 @@
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include "bst.h"
+#include "avlbst.h"
+#include "parentlessavl.h"
+
+using namespace std;
+
+// Node memory and insert/find/scan/remove throughput of AVLTree against
+// ParentlessAVLTree, on the same shuffled keys.
+//
+// usage: bench-parentless [num_keys]
+
+typedef chrono::steady_clock::time_point TimePoint;
+
+double nsPer(TimePoint start, TimePoint stop, size_t count)
+{
+    return chrono::duration<double, nano>(stop - start).count() / count;
+}
+
+template<typename Tree>
+void runPhases(const char* name, const vector<int>& keys, const vector<int>& probes)
+{
+    Tree tree;
+    long long sum = 0;
+
+    TimePoint t0 = chrono::steady_clock::now();
+    for(size_t i = 0; i < keys.size(); ++i){
+      tree.insert(make_pair(keys[i], keys[i]));
+    }
+    TimePoint t1 = chrono::steady_clock::now();
+    for(size_t i = 0; i < probes.size(); ++i){
+      if(tree.find(probes[i]) != tree.end()){
+        sum += probes[i];
+      }
+    }
+    TimePoint t2 = chrono::steady_clock::now();
+    for(typename Tree::iterator it = tree.begin(); it != tree.end(); ++it){
+      sum -= it->second;
+    }
+    TimePoint t3 = chrono::steady_clock::now();
+    size_t bytes = tree.memoryUsage();
+    for(size_t i = 0; i < keys.size(); ++i){
+      tree.remove(keys[i]);
+    }
+    TimePoint t4 = chrono::steady_clock::now();
+
+    cout << name << bytes / (1024 * 1024) << " MB (" << bytes / keys.size() << " B/node)  "
+         << "insert " << nsPer(t0, t1, keys.size()) << "  find " << nsPer(t1, t2, probes.size())
+         << "  scan " << nsPer(t2, t3, keys.size()) << "  remove " << nsPer(t3, t4, keys.size())
+         << " ns/op  checksum " << sum << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    int numKeys = (argc > 1) ? atoi(argv[1]) : 2000000;
+
+    mt19937 rng(104);
+    vector<int> keys(numKeys);
+    for(int i = 0; i < numKeys; ++i){
+      keys[i] = 2 * i; // odd probes miss
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+    vector<int> probes(numKeys);
+    for(int i = 0; i < numKeys; ++i){
+      probes[i] = rng() % (2 * numKeys);
+    }
+
+    cout << "keys: " << numKeys << endl;
+    runPhases<AVLTree<int, int> >("AVLTree:           ", keys, probes);
+    runPhases<ParentlessAVLTree<int, int> >("ParentlessAVLTree: ", keys, probes);
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <chrono>
+#include "bst.h"
+#include "avlbst.h"
+#include "rbbst.h"
+
+using namespace std;
+
+// Head-to-head of RBTree and AVLTree on mixes of insert/remove/find.
+// Each mix starts from a tree holding half of the key space and runs the
+// same pre-generated operation stream on both trees.
+//
+// usage: bench-rbtree [num_keys] [num_ops]
+
+struct Mix {
+    const char* name;
+    int insertPct;
+    int removePct;  // the rest are finds
+};
+
+struct Op {
+    int kind;   // 0 insert, 1 remove, 2 find
+    int key;
+};
+
+template<typename Tree>
+double runMix(const vector<int>& prefill, const vector<Op>& ops, long long& checksum)
+{
+    Tree tree;
+    for(size_t i = 0; i < prefill.size(); ++i){
+      tree.insert(make_pair(prefill[i], prefill[i]));
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(size_t i = 0; i < ops.size(); ++i){
+      if(ops[i].kind == 0){
+        tree.insert(make_pair(ops[i].key, ops[i].key));
+      }
+      else if(ops[i].kind == 1){
+        tree.remove(ops[i].key);
+      }
+      else if(tree.find(ops[i].key) != tree.end()){
+        checksum += ops[i].key;
+      }
+    }
+    chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(stop - start).count() / ops.size();
+}
+
+int main(int argc, char *argv[])
+{
+    int numKeys = (argc > 1) ? atoi(argv[1]) : 1000000;
+    int numOps = (argc > 2) ? atoi(argv[2]) : 2000000;
+
+    const Mix mixes[] = {
+      { "insert-heavy  70/10/20", 70, 10 },
+      { "balanced      50/50/0 ", 50, 50 },
+      { "delete-heavy  10/70/20", 10, 70 },
+      { "read-mostly    5/5/90 ", 5, 5 },
+    };
+
+    mt19937 rng(104);
+    uniform_int_distribution<int> keyDist(0, 2 * numKeys - 1);
+    vector<int> prefill(numKeys);
+    for(int i = 0; i < numKeys; ++i){
+      prefill[i] = keyDist(rng);
+    }
+
+    cout << "keys: " << numKeys << "  ops per mix: " << numOps << endl;
+    cout << "mix (ins/rem/find)        AVLTree ns/op   RBTree ns/op" << endl;
+    for(size_t m = 0; m < sizeof(mixes) / sizeof(mixes[0]); ++m){
+      vector<Op> ops(numOps);
+      for(int i = 0; i < numOps; ++i){
+        int roll = rng() % 100;
+        ops[i].kind = (roll < mixes[m].insertPct) ? 0 : (roll < mixes[m].insertPct + mixes[m].removePct) ? 1 : 2;
+        ops[i].key = keyDist(rng);
+      }
+
+      long long avlSum = 0, rbSum = 0;
+      double avlNs = runMix<AVLTree<int, int> >(prefill, ops, avlSum);
+      double rbNs = runMix<RBTree<int, int> >(prefill, ops, rbSum);
+      cout << mixes[m].name << "    " << avlNs << "\t\t" << rbNs << endl;
+      if(avlSum != rbSum){
+        cout << "checksum mismatch!" << endl;
+        return 1;
+      }
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include "bst.h"
+#include "avlbst.h"
+
+using namespace std;
+
+// A write burst against an AVLTree, eager and with relaxed balance at a few
+// bounds: insert time during the burst, the rebalance() pass that follows
+// it, and the find time on the tree before and after that pass. One burst
+// scatters new keys between the loaded ones, the other appends ascending
+// keys past them, the pattern that makes an eager tree rotate the most.
+//
+// usage: bench-relaxed [num_keys] [burst] [num_probes]
+
+typedef chrono::steady_clock::time_point TimePoint;
+
+double nsPer(TimePoint start, TimePoint stop, size_t count)
+{
+    return chrono::duration<double, nano>(stop - start).count() / count;
+}
+
+double findTime(const AVLTree<int, int>& tree, const vector<int>& probes, long long& hits)
+{
+    TimePoint start = chrono::steady_clock::now();
+    for(size_t i = 0; i < probes.size(); ++i){
+      hits += (tree.find(probes[i]) != tree.end());
+    }
+    return nsPer(start, chrono::steady_clock::now(), probes.size());
+}
+
+void runBurst(const char* name, int bound, const vector<int>& keys, const vector<int>& burst, const vector<int>& probes)
+{
+    AVLTree<int, int> tree;
+    for(size_t i = 0; i < keys.size(); ++i){
+      tree.insert(make_pair(keys[i], keys[i]));
+    }
+    tree.setRelaxedBalance(bound);
+    long long hits = 0;
+
+    TimePoint t0 = chrono::steady_clock::now();
+    for(size_t i = 0; i < burst.size(); ++i){
+      tree.insert(make_pair(burst[i], burst[i]));
+    }
+    TimePoint t1 = chrono::steady_clock::now();
+    double during = findTime(tree, probes, hits);
+    TimePoint t2 = chrono::steady_clock::now();
+    tree.rebalance();
+    TimePoint t3 = chrono::steady_clock::now();
+    double after = findTime(tree, probes, hits);
+
+    cout << name << " bound " << bound << ":  insert " << nsPer(t0, t1, burst.size()) << " ns/op  rebalance "
+         << chrono::duration<double, milli>(t3 - t2).count() << " ms  find " << during << " -> " << after
+         << " ns/op  hits " << hits << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    int numKeys = (argc > 1) ? atoi(argv[1]) : 1000000;
+    int burstSize = (argc > 2) ? atoi(argv[2]) : 1000000;
+    int numProbes = (argc > 3) ? atoi(argv[3]) : 1000000;
+
+    mt19937 rng(104);
+    vector<int> keys(numKeys), scattered(burstSize), ascending(burstSize), probes(numProbes);
+    for(int i = 0; i < numKeys; ++i){
+      keys[i] = 2 * i;
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+    for(int i = 0; i < burstSize; ++i){
+      scattered[i] = 2 * (int)(rng() % numKeys) + 1; // new keys between the loaded ones
+      ascending[i] = 2 * numKeys + i;
+    }
+    for(int i = 0; i < numProbes; ++i){
+      probes[i] = rng() % (2 * numKeys + burstSize);
+    }
+
+    cout << "keys: " << numKeys << "  burst: " << burstSize << "  probes: " << numProbes << endl;
+    int bounds[4] = { 1, 2, 4, 8 };
+    for(int b = 0; b < 4; ++b){
+      runBurst("scattered", bounds[b], keys, scattered, probes);
+    }
+    for(int b = 0; b < 4; ++b){
+      runBurst("ascending", bounds[b], keys, ascending, probes);
+    }
+    return 0;
+}
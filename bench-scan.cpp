@@ -0,0 +1,66 @@
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include "bst.h"
+#include "avlbst.h"
+#include "threadedbst.h"
+
+using namespace std;
+
+// Full-tree scan throughput of AVLTree (successor() climbs parent links)
+// against ThreadedAVLTree (follows the in-order thread), both forward and
+// in reverse.
+//
+// usage: bench-scan [num_keys] [num_scans]
+
+template<typename Tree>
+void timeScans(const char* name, int numKeys, int numScans, const vector<int>& keys)
+{
+    Tree tree;
+    for(size_t i = 0; i < keys.size(); ++i){
+      tree.insert(make_pair(keys[i], keys[i]));
+    }
+
+    long long sum = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(int s = 0; s < numScans; ++s){
+      for(typename Tree::iterator it = tree.begin(); it != tree.end(); ++it){
+        sum += it->second;
+      }
+    }
+    chrono::steady_clock::time_point mid = chrono::steady_clock::now();
+    for(int s = 0; s < numScans; ++s){
+      for(typename Tree::reverse_iterator it = tree.rbegin(); it != tree.rend(); ++it){
+        sum -= it->second;
+      }
+    }
+    chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+
+    double items = (double)numKeys * numScans;
+    double forwardNs = chrono::duration<double, nano>(mid - start).count() / items;
+    double reverseNs = chrono::duration<double, nano>(stop - mid).count() / items;
+    cout << name << forwardNs << " ns/item forward (" << 1000.0 / forwardNs << " M items/s), "
+         << reverseNs << " ns/item reverse" << (sum != 0 ? "  checksum mismatch!" : "") << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    int numKeys = (argc > 1) ? atoi(argv[1]) : 2000000;
+    int numScans = (argc > 2) ? atoi(argv[2]) : 5;
+
+    // random insertion order scatters neighbouring keys across the heap
+    mt19937 rng(104);
+    vector<int> keys(numKeys);
+    for(int i = 0; i < numKeys; ++i){
+      keys[i] = i;
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+
+    cout << "keys: " << numKeys << "  scans: " << numScans << endl;
+    timeScans<AVLTree<int, int> >("AVLTree:         ", numKeys, numScans, keys);
+    timeScans<ThreadedAVLTree<int, int> >("ThreadedAVLTree: ", numKeys, numScans, keys);
+    return 0;
+}
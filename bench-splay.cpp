@@ -0,0 +1,100 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include "bst.h"
+#include "avlbst.h"
+#include "splaybst.h"
+
+using namespace std;
+
+// Compares SplayTree against AVLTree on lookups whose keys follow a Zipf
+// distribution, i.e. a small set of hot keys gets most of the traffic.
+//
+// usage: bench-splay [num_keys] [num_lookups] [zipf_exponent]
+
+// Draws ranks 0..n-1 with P(k) proportional to 1/(k+1)^s.
+class ZipfGenerator
+{
+public:
+    ZipfGenerator(int n, double s) : cdf_(n)
+    {
+        double sum = 0;
+        for(int k = 0; k < n; ++k){
+          sum += 1.0 / pow(k + 1, s);
+          cdf_[k] = sum;
+        }
+        for(int k = 0; k < n; ++k){
+          cdf_[k] /= sum;
+        }
+    }
+
+    int operator()(mt19937& rng)
+    {
+        double u = uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin();
+    }
+
+private:
+    vector<double> cdf_;
+};
+
+// Builds the tree from keys, then times the lookups and returns ns per lookup.
+template<typename Tree>
+double timeLookups(Tree& tree, const vector<int>& keys, const vector<int>& lookups, long long& checksum)
+{
+    for(size_t i = 0; i < keys.size(); ++i){
+      tree.insert(make_pair(keys[i], keys[i]));
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(size_t i = 0; i < lookups.size(); ++i){
+      checksum += tree.find(lookups[i])->second;
+    }
+    chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(stop - start).count() / lookups.size();
+}
+
+int main(int argc, char *argv[])
+{
+    int numKeys = (argc > 1) ? atoi(argv[1]) : 1000000;
+    int numLookups = (argc > 2) ? atoi(argv[2]) : 5000000;
+    double exponent = (argc > 3) ? atof(argv[3]) : 1.0;
+
+    mt19937 rng(104);
+    vector<int> keys(numKeys);
+    for(int i = 0; i < numKeys; ++i){
+      keys[i] = i;
+    }
+    shuffle(keys.begin(), keys.end(), rng); // insertion order and hotness are both random
+
+    ZipfGenerator zipf(numKeys, exponent);
+    vector<int> lookups(numLookups);
+    for(int i = 0; i < numLookups; ++i){
+      lookups[i] = keys[zipf(rng)];
+    }
+
+    long long avlSum = 0, splaySum = 0;
+    double avlNs, splayNs;
+    {
+      AVLTree<int, int> avl;
+      avlNs = timeLookups(avl, keys, lookups, avlSum);
+    }
+    {
+      SplayTree<int, int> splay;
+      splayNs = timeLookups(splay, keys, lookups, splaySum);
+    }
+
+    cout << "keys: " << numKeys << "  lookups: " << numLookups
+         << "  zipf s: " << exponent << endl;
+    cout << "AVLTree:   " << avlNs << " ns/lookup" << endl;
+    cout << "SplayTree: " << splayNs << " ns/lookup" << endl;
+    if(avlSum != splaySum){
+      cout << "checksum mismatch!" << endl;
+      return 1;
+    }
+    return 0;
+}
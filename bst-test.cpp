@@ -2,6 +2,18 @@
 #include <map>
 #include "bst.h"
 #include "avlbst.h"
+#include "splaybst.h"
+#include "rbbst.h"
+#include "threadedbst.h"
+#include "bufferedbst.h"
+#include "parentlessavl.h"
+#include "intervalbst.h"
+#include "aggregatebst.h"
+#include "multibst.h"
+#include "tree-export.h"
+#include "bulkload.h"
+#include <fstream>
+#include <cstdio>
 
 using namespace std;
 
@@ -26,6 +38,14 @@ int main(int argc, char *argv[])
     cout << "Erasing b" << endl;
     bt.remove('b');
 
+    // Scapegoat mode keeps sorted inserts from degenerating into a list
+    BinarySearchTree<int,int> sg;
+    sg.setScapegoatAlpha(0.7);
+    for(int i = 0; i < 1000; ++i) {
+        sg.insert(std::make_pair(i, i));
+    }
+    cout << "\nScapegoat BST holds " << sg.size() << " sorted inserts" << endl;
+
     // AVL Tree Tests
     AVLTree<char,int> at;
     at.insert(std::make_pair('a',1));
@@ -35,14 +55,199 @@ int main(int argc, char *argv[])
     for(AVLTree<char,int>::iterator it = at.begin(); it != at.end(); ++it) {
         cout << it->first << " " << it->second << endl;
     }
+    cout << "AVLTree holds " << at.memoryUsage() << " bytes of nodes" << endl;
+    cout << "AVLTree as JSON: ";
+    exportJSON(at, cout);
+    cout << "AVLTree contents in reverse:" << endl;
+    for(AVLTree<char,int>::reverse_iterator it = at.rbegin(); it != at.rend(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
     if(at.find('b') != at.end()) {
         cout << "Found b" << endl;
     }
     else {
         cout << "Did not find b" << endl;
     }
+    AVLTree<char,int> atCopy(at);
     cout << "Erasing b" << endl;
     at.remove('b');
+    cout << "Copy still has " << atCopy.size() << " items" << endl;
+
+    // Splay Tree Tests
+    SplayTree<char,int> st;
+    st.insert(std::make_pair('a',1));
+    st.insert(std::make_pair('b',2));
+    st.insert(std::make_pair('c',3));
+
+    cout << "\nSplayTree contents:" << endl;
+    for(SplayTree<char,int>::iterator it = st.begin(); it != st.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    if(st.find('a') != st.end()) {
+        cout << "Found a" << endl;
+    }
+    else {
+        cout << "Did not find a" << endl;
+    }
+    st.print();
+    cout << "Erasing b" << endl;
+    st.remove('b');
+
+    // Red-Black Tree Tests
+    RBTree<char,int> rt;
+    rt.insert(std::make_pair('a',1));
+    rt.insert(std::make_pair('b',2));
+    rt.insert(std::make_pair('c',3));
+
+    cout << "\nRBTree contents:" << endl;
+    for(RBTree<char,int>::iterator it = rt.begin(); it != rt.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    cout << "Erasing b" << endl;
+    rt.remove('b');
+    try {
+        rt.setScapegoatAlpha(0.7);
+        cout << "RBTree accepted scapegoat mode" << endl;
+    }
+    catch(const std::invalid_argument&) {
+        cout << "RBTree rejects scapegoat mode" << endl;
+    }
+
+    // Threaded AVL Tree Tests
+    ThreadedAVLTree<char,int> tt;
+    tt.insert(std::make_pair('b',2));
+    tt.insert(std::make_pair('a',1));
+    tt.insert(std::make_pair('c',3));
+    tt.remove('b');
+
+    cout << "\nThreadedAVLTree contents:" << endl;
+    for(ThreadedAVLTree<char,int>::iterator it = tt.begin(); it != tt.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+
+    // AVL Tree with tombstones
+    AVLTree<int,int> lt;
+    lt.setTombstones(true, 0.5);
+    for(int i = 0; i < 8; ++i) {
+        lt.insert(std::make_pair(i, i * i));
+    }
+    lt.remove(2);
+    lt.remove(5);
+    cout << "\nAVLTree with " << lt.tombstones() << " tombstones:" << endl;
+    for(AVLTree<int,int>::iterator it = lt.begin(); it != lt.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    cout << "As JSON, tombstones marked dead: ";
+    exportJSON(lt, cout);
+    lt.compact();
+    cout << "After compaction: " << lt.size() << " items, " << lt.tombstones() << " tombstones" << endl;
+    int lookups[] = { 1, 2, 7, 9 };
+    AVLTree<int,int>::iterator found[4];
+    lt.findBatch(lookups, 4, found);
+    for(int i = 0; i < 4; ++i) {
+        cout << "Batch lookup " << lookups[i] << ": " << (found[i] != lt.end() ? "found" : "missing") << endl;
+    }
+    size_t erased = lt.eraseRange(3, 6);
+    cout << "Erased " << erased << " items in [3, 6], " << lt.size() << " left, balanced: " << lt.isBalanced() << endl;
+    lt.enableHashIndex();
+    lt.insert(std::make_pair(10, 100));
+    cout << "Hash index lookups: 10 -> " << lt[10] << ", 4 " << (lt.find(4) != lt.end() ? "found" : "missing") << endl;
+    lt.disableHashIndex();
+    lt.setFingerSearch(true);
+    cout << "Finger lookups: 7 -> " << lt[7] << ", then 1 -> " << lt[1] << endl;
+    lt.setFingerSearch(false);
+    lt.setRelaxedBalance(4);
+    for(int i = 20; i < 40; ++i) {
+        lt.insert(std::make_pair(i, i));
+    }
+    cout << "Relaxed burst: " << lt.size() << " items, balanced: " << lt.isBalanced();
+    lt.rebalance();
+    cout << ", after rebalance: " << lt.isBalanced() << endl;
+    lt.setRelaxedBalance(1);
+
+    // Buffered AVL Tree Tests
+    BufferedTree<int,int> wt(4);
+    for(int i = 0; i < 6; ++i) {
+        wt.insert(std::make_pair(i * 3 % 7, i));
+    }
+    cout << "\nBufferedTree contents (" << wt.tree().size() << " merged):" << endl;
+    for(BufferedTree<int,int>::iterator it = wt.begin(); it != wt.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    if(wt.find(1) != wt.end()) {
+        cout << "Found 1" << endl;
+    }
+
+    // Parentless AVL Tree Tests
+    ParentlessAVLTree<char,int> pt;
+    pt.insert(std::make_pair('c',3));
+    pt.insert(std::make_pair('a',1));
+    pt.insert(std::make_pair('b',2));
+    pt.insert(std::make_pair('d',4));
+    pt.remove('c');
+
+    cout << "\nParentlessAVLTree contents:" << endl;
+    for(ParentlessAVLTree<char,int>::iterator it = pt.begin(); it != pt.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    cout << "Balanced: " << pt.isBalanced() << ", " << pt.memoryUsage() << " bytes of nodes" << endl;
+
+    // Interval Tree Tests
+    IntervalTree<int,char> vt;
+    vt.insert(std::make_pair(std::make_pair(1,5),'a'));
+    vt.insert(std::make_pair(std::make_pair(3,4),'b'));
+    vt.insert(std::make_pair(std::make_pair(6,9),'c'));
+    vt.insert(std::make_pair(std::make_pair(8,12),'d'));
+    vt.remove(std::make_pair(3,4));
+
+    cout << "\nIntervalTree overlaps with [4, 7]:" << endl;
+    std::vector<IntervalTree<int,char>::iterator> hits = vt.overlaps(4, 7);
+    for(size_t i = 0; i < hits.size(); ++i) {
+        cout << hits[i]->first.first << "-" << hits[i]->first.second << " " << hits[i]->second << endl;
+    }
+    cout << "Intervals containing 8: " << vt.stab(8).size() << endl;
+
+    // Aggregate Tree Tests
+    AggregateTree<int,int> qt;
+    for(int i = 1; i <= 10; ++i) {
+        qt.insert(std::make_pair(i, i * i));
+    }
+    qt.remove(4);
+    int total = 0;
+    if(qt.aggregate(2, 6, total)) {
+        cout << "\nAggregateTree sum of squares over [2, 6] without 4: " << total << endl;
+    }
+
+    // Multi AVL Tree Tests
+    MultiAVLTree<char,int> mt;
+    mt.insert(std::make_pair('b',1));
+    mt.insert(std::make_pair('a',2));
+    mt.insert(std::make_pair('b',3));
+    mt.insert(std::make_pair('b',4));
+    mt.remove('b');
+
+    cout << "\nMultiAVLTree holds " << mt.size() << " items under " << mt.distinctKeys() << " keys:" << endl;
+    for(MultiAVLTree<char,int>::value_iterator it = mt.beginElements(); it != mt.endElements(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    cout << "Count of b: " << mt.count('b') << endl;
+
+    // Bulk loading keeps duplicate keys in a MultiAVLTree and collapses them in an AVLTree
+    const char* bulkFile = "bst-test-bulk.txt";
+    {
+        ofstream out(bulkFile);
+        out << "2,20\n1,10\n1,11\n";
+    }
+    MultiAVLTree<int,int> bm;
+    AVLTree<int,int> ba;
+    bulkLoad(bulkFile, BULK_TEXT, bm, 1);
+    bulkLoad(bulkFile, BULK_TEXT, ba, 1);
+    std::remove(bulkFile);
+    cout << "Bulk-loaded MultiAVLTree: " << bm.size() << " items, count of 1: " << bm.count(1) << ":";
+    for(MultiAVLTree<int,int>::value_iterator it = bm.beginElements(); it != bm.endElements(); ++it) {
+        cout << " " << it->first << "," << it->second;
+    }
+    cout << endl << "Bulk-loaded AVLTree: " << ba.size() << " items, 1 -> " << ba[1] << endl;
 
     return 0;
 }
@@ -5,6 +5,22 @@
 #include <exception>
 #include <cstdlib>
 #include <utility>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <iterator>
+#include <cstddef>
+#include <memory>
+#include <functional>
+
+// Hint that a node is about to be read. Only a hint, so it is a no-op on
+// compilers without the builtin.
+#if defined(__GNUC__) || defined(__clang__)
+#define BST_PREFETCH(ptr) __builtin_prefetch(ptr)
+#else
+#define BST_PREFETCH(ptr) ((void)0)
+#endif
 
 /**
  * A templated class for a Node in a search tree.
@@ -29,17 +45,18 @@ public:
     virtual Node<Key, Value>* getParent() const;
     virtual Node<Key, Value>* getLeft() const;
     virtual Node<Key, Value>* getRight() const;
+    Node<Key, Value>* getChild(int dir) const;
 
     void setParent(Node<Key, Value>* parent);
     void setLeft(Node<Key, Value>* left);
     void setRight(Node<Key, Value>* right);
+    void setChild(int dir, Node<Key, Value>* child);
     void setValue(const Value &value);
 
 protected:
     std::pair<const Key, Value> item_;
     Node<Key, Value>* parent_;
-    Node<Key, Value>* left_;
-    Node<Key, Value>* right_;
+    Node<Key, Value>* child_[2]; // left, right; indexed by (getKey() < key)
 };
 
 /*
@@ -55,8 +72,7 @@ template<typename Key, typename Value>
 Node<Key, Value>::Node(const Key& key, const Value& value, Node<Key, Value>* parent) :
     item_(key, value),
     parent_(parent),
-    left_(NULL),
-    right_(NULL)
+    child_()
 {
 
 }
@@ -132,7 +148,7 @@ Node<Key, Value>* Node<Key, Value>::getParent() const
 template<typename Key, typename Value>
 Node<Key, Value>* Node<Key, Value>::getLeft() const
 {
-    return left_;
+    return child_[0];
 }
 
 /**
@@ -141,7 +157,17 @@ Node<Key, Value>* Node<Key, Value>::getLeft() const
 template<typename Key, typename Value>
 Node<Key, Value>* Node<Key, Value>::getRight() const
 {
-    return right_;
+    return child_[1];
+}
+
+/**
+* Non-virtual child getter: 0 is left, 1 is right. Descents index it with a
+* comparison result instead of branching on it.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* Node<Key, Value>::getChild(int dir) const
+{
+    return child_[dir];
 }
 
 /**
@@ -159,7 +185,7 @@ void Node<Key, Value>::setParent(Node<Key, Value>* parent)
 template<typename Key, typename Value>
 void Node<Key, Value>::setLeft(Node<Key, Value>* left)
 {
-    left_ = left;
+    child_[0] = left;
 }
 
 /**
@@ -168,7 +194,16 @@ void Node<Key, Value>::setLeft(Node<Key, Value>* left)
 template<typename Key, typename Value>
 void Node<Key, Value>::setRight(Node<Key, Value>* right)
 {
-    right_ = right;
+    child_[1] = right;
+}
+
+/**
+* A setter for either child, 0 for left and 1 for right.
+*/
+template<typename Key, typename Value>
+void Node<Key, Value>::setChild(int dir, Node<Key, Value>* child)
+{
+    child_[dir] = child;
 }
 
 /**
@@ -187,30 +222,264 @@ void Node<Key, Value>::setValue(const Value& value)
 */
 
 /**
-* A templated unbalanced binary search tree.
+* An open-addressing (linear probing) hash table from key to node, used as
+* an optional side index for point lookups. Each slot caches the key's hash
+* so probes rarely touch a node that does not match and growing never
+* rehashes a key. Erase shifts later entries back instead of leaving
+* tombstones. The table is off (and empty) until reset() gives it a hash
+* function; the tree decides which hash that is, so keys without a
+* std::hash cost nothing unless the index is turned on.
 */
 template <typename Key, typename Value>
+class NodeHashIndex
+{
+public:
+    typedef size_t (*HashFunction)(const Key& key);
+
+    NodeHashIndex();
+
+    void reset(HashFunction hash);
+    bool enabled() const;
+    HashFunction hashFunction() const;
+    void insert(Node<Key, Value>* node);
+    void erase(Node<Key, Value>* node);
+    Node<Key, Value>* find(const Key& key) const;
+    void swap(NodeHashIndex<Key, Value>& other);
+    size_t memoryUsage() const;
+
+protected:
+    struct Slot
+    {
+        Node<Key, Value>* node; // NULL when the slot is free
+        size_t hash;
+    };
+
+    size_t home(size_t hash) const;
+    void grow();
+
+    HashFunction hash_;
+    std::vector<Slot> slots_;
+    size_t count_;
+    int shift_;             // home() keeps the top (64 - shift_) bits of the mixed hash
+};
+
+/*
+  --------------------------------------------------
+  Begin implementations for the NodeHashIndex class.
+  --------------------------------------------------
+*/
+
+template<typename Key, typename Value>
+NodeHashIndex<Key, Value>::NodeHashIndex() : hash_(NULL), count_(0), shift_(64)
+{
+
+}
+
+/**
+* Empties the index and sets the hash it uses; a NULL hash turns it off.
+*/
+template<typename Key, typename Value>
+void NodeHashIndex<Key, Value>::reset(HashFunction hash)
+{
+    hash_ = hash;
+    std::vector<Slot>().swap(slots_);
+    count_ = 0;
+    shift_ = 64;
+}
+
+template<typename Key, typename Value>
+bool NodeHashIndex<Key, Value>::enabled() const
+{
+    return hash_ != NULL;
+}
+
+template<typename Key, typename Value>
+typename NodeHashIndex<Key, Value>::HashFunction NodeHashIndex<Key, Value>::hashFunction() const
+{
+    return hash_;
+}
+
+/**
+* Adds node under its key. The tree never indexes two live nodes with the
+* same key, so there is no duplicate check. The table doubles before it
+* gets more than half full.
+*/
+template<typename Key, typename Value>
+void NodeHashIndex<Key, Value>::insert(Node<Key, Value>* node)
+{
+    if(2 * (count_ + 1) > slots_.size()){
+      grow();
+    }
+    size_t hash = hash_(node->getKey());
+    size_t mask = slots_.size() - 1;
+    size_t i = home(hash);
+    while(slots_[i].node != NULL){
+      i = (i + 1) & mask;
+    }
+    slots_[i].node = node;
+    slots_[i].hash = hash;
+    ++count_;
+}
+
+/**
+* Removes node (found by pointer, not key), then shifts back every later
+* entry of the probe run that may move into the hole, so lookups never
+* need to skip deleted slots.
+*/
+template<typename Key, typename Value>
+void NodeHashIndex<Key, Value>::erase(Node<Key, Value>* node)
+{
+    if(count_ == 0){
+      return;
+    }
+    size_t mask = slots_.size() - 1;
+    size_t hole = home(hash_(node->getKey()));
+    while(slots_[hole].node != node){
+      if(slots_[hole].node == NULL){ // not indexed
+        return;
+      }
+      hole = (hole + 1) & mask;
+    }
+    for(size_t j = (hole + 1) & mask; slots_[j].node != NULL; j = (j + 1) & mask){
+      // the entry at j can fill the hole if its home is not after the hole
+      if(((j - home(slots_[j].hash)) & mask) >= ((j - hole) & mask)){
+        slots_[hole] = slots_[j];
+        hole = j;
+      }
+    }
+    slots_[hole].node = NULL;
+    --count_;
+}
+
+/**
+* The node with the given key, or NULL.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* NodeHashIndex<Key, Value>::find(const Key& key) const
+{
+    if(count_ == 0){
+      return NULL;
+    }
+    size_t hash = hash_(key);
+    size_t mask = slots_.size() - 1;
+    for(size_t i = home(hash); slots_[i].node != NULL; i = (i + 1) & mask){
+      const Slot& slot = slots_[i];
+      if(slot.hash == hash && !(key < slot.node->getKey()) && !(slot.node->getKey() < key)){
+        return slot.node;
+      }
+    }
+    return NULL;
+}
+
+template<typename Key, typename Value>
+void NodeHashIndex<Key, Value>::swap(NodeHashIndex<Key, Value>& other)
+{
+    std::swap(hash_, other.hash_);
+    slots_.swap(other.slots_);
+    std::swap(count_, other.count_);
+    std::swap(shift_, other.shift_);
+}
+
+template<typename Key, typename Value>
+size_t NodeHashIndex<Key, Value>::memoryUsage() const
+{
+    return slots_.capacity() * sizeof(Slot);
+}
+
+/**
+* Fibonacci hashing: multiplying by 2^64 / phi spreads the bits of weak
+* hashes (std::hash of an int is the int itself) over the top bits.
+*/
+template<typename Key, typename Value>
+size_t NodeHashIndex<Key, Value>::home(size_t hash) const
+{
+    return (size_t)(((unsigned long long)hash * 0x9E3779B97F4A7C15ULL) >> shift_);
+}
+
+template<typename Key, typename Value>
+void NodeHashIndex<Key, Value>::grow()
+{
+    std::vector<Slot> old;
+    old.swap(slots_);
+    size_t capacity = old.empty() ? 16 : 2 * old.size();
+    Slot empty = { NULL, 0 };
+    slots_.assign(capacity, empty);
+    shift_ = 64;
+    for(size_t bits = capacity; bits > 1; bits >>= 1){
+      --shift_;
+    }
+    size_t mask = capacity - 1;
+    for(size_t j = 0; j < old.size(); ++j){
+      if(old[j].node != NULL){
+        size_t i = home(old[j].hash);
+        while(slots_[i].node != NULL){
+          i = (i + 1) & mask;
+        }
+        slots_[i] = old[j];
+      }
+    }
+}
+
+/*
+  ------------------------------------------------
+  End implementations for the NodeHashIndex class.
+  ------------------------------------------------
+*/
+
+/**
+* A templated unbalanced binary search tree.
+*/
+template <typename Key, typename Value,
+          typename Alloc = std::allocator<std::pair<const Key, Value> > >
 class BinarySearchTree
 {
 public:
     BinarySearchTree(); //TODO
+    explicit BinarySearchTree(const Alloc& alloc);
+    BinarySearchTree(const BinarySearchTree& other);
+    BinarySearchTree(BinarySearchTree&& other);
+    BinarySearchTree& operator=(const BinarySearchTree& other);
+    BinarySearchTree& operator=(BinarySearchTree&& other);
+    void swap(BinarySearchTree& other);
     virtual ~BinarySearchTree(); //TODO
     virtual void insert(const std::pair<const Key, Value>& keyValuePair); //TODO
     virtual void remove(const Key& key); //TODO
-    void clear(); //TODO
+    virtual size_t eraseRange(const Key& lo, const Key& hi);
+    virtual void clear(); //TODO
     bool isBalanced() const; //TODO
     void print() const;
     bool empty() const;
-
-    template<typename PPKey, typename PPValue>
-    friend void prettyPrintBST(BinarySearchTree<PPKey, PPValue> & tree);
+    size_t size() const;
+    size_t memoryUsage() const;
+    Alloc get_allocator() const;
+    virtual void setScapegoatAlpha(double alpha);
+    template<typename Hash = std::hash<Key> >
+    void enableHashIndex();
+    void disableHashIndex();
+    bool hashIndexEnabled() const;
+    void setFingerSearch(bool enabled);
+    bool fingerSearchEnabled() const;
+
+    template<typename PPKey, typename PPValue, typename PPAlloc>
+    friend void prettyPrintBST(BinarySearchTree<PPKey, PPValue, PPAlloc> & tree);
+    template<typename EKey, typename EValue, typename EAlloc>
+    friend Node<EKey, EValue>* exportStartNode(const BinarySearchTree<EKey, EValue, EAlloc>& tree, const EKey* key);
+    template<typename EKey, typename EValue, typename EAlloc>
+    friend bool exportNodeVisible(const BinarySearchTree<EKey, EValue, EAlloc>& tree, Node<EKey, EValue>* node);
 public:
     /**
     * An internal iterator class for traversing the contents of the BST.
+    * It is bidirectional: decrementing end() lands on the largest item.
     */
     class iterator  // TODO
     {
     public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef std::pair<const Key, Value> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::pair<const Key, Value>* pointer;
+        typedef std::pair<const Key, Value>& reference;
+
         iterator();
 
         std::pair<const Key,Value>& operator*() const;
@@ -220,24 +489,70 @@ public:
         bool operator!=(const iterator& rhs) const;
 
         iterator& operator++();
+        iterator& operator--();
 
     protected:
-        friend class BinarySearchTree<Key, Value>;
-        iterator(Node<Key,Value>* ptr);
+        friend class BinarySearchTree<Key, Value, Alloc>;
+        iterator(Node<Key,Value>* ptr, const BinarySearchTree<Key, Value, Alloc>* tree);
         Node<Key, Value> *current_;
+        const BinarySearchTree<Key, Value, Alloc>* tree_;
+    };
+
+    /**
+    * The read-only counterpart of iterator. Any iterator converts to it.
+    */
+    class const_iterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef std::pair<const Key, Value> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const std::pair<const Key, Value>* pointer;
+        typedef const std::pair<const Key, Value>& reference;
+
+        const_iterator();
+        const_iterator(const iterator& it);
+
+        const std::pair<const Key,Value>& operator*() const;
+        const std::pair<const Key,Value>* operator->() const;
+
+        bool operator==(const const_iterator& rhs) const;
+        bool operator!=(const const_iterator& rhs) const;
+
+        const_iterator& operator++();
+        const_iterator& operator--();
+
+    protected:
+        iterator it_;
     };
 
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
 public:
     iterator begin() const;
     iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    reverse_iterator rbegin() const;
+    reverse_iterator rend() const;
+    reverse_iterator rbegin(const Key& key) const;
+    const_reverse_iterator crbegin() const;
+    const_reverse_iterator crend() const;
     iterator find(const Key& key) const;
+    void findBatch(const Key* keys, size_t count, iterator* out) const;
+    iterator lower_bound(const Key& key) const;
+    iterator upper_bound(const Key& key) const;
     Value& operator[](const Key& key);
     Value const & operator[](const Key& key) const;
 
 protected:
     // Mandatory helper functions
-    Node<Key, Value>* internalFind(const Key& k) const; // TODO
+    virtual Node<Key, Value>* internalFind(const Key& k) const; // TODO
+    static Node<Key, Value>* descendFrom(Node<Key, Value>* start, const Key& key);
+    Node<Key, Value>* fingerFind(const Key& key) const;
     Node<Key, Value> *getSmallestNode() const;  // TODO
+    Node<Key, Value> *getLargestNode() const;
     static Node<Key, Value>* predecessor(Node<Key, Value>* current); // TODO
     // Note:  static means these functions don't have a "this" pointer
     //        and instead just use the input argument.
@@ -245,15 +560,58 @@ protected:
     // Provided helper functions
     virtual void printRoot (Node<Key, Value> *r) const;
     virtual void nodeSwap( Node<Key,Value>* n1, Node<Key,Value>* n2) ;
+    void rotateLeft(Node<Key, Value>* node);
+    void rotateRight(Node<Key, Value>* node);
+    iterator makeIterator(Node<Key, Value>* node) const;
 
     // Add helper functions here
     static Node<Key, Value>* successor(Node<Key, Value>* current);
+    virtual Node<Key, Value>* nextNode(Node<Key, Value>* current) const;
+    virtual Node<Key, Value>* prevNode(Node<Key, Value>* current) const;
+    virtual Node<Key, Value>* firstVisible(Node<Key, Value>* node) const;
+    virtual Node<Key, Value>* lastVisible(Node<Key, Value>* node) const;
+    virtual bool isVisible(Node<Key, Value>* node) const;
     int balanceHelper(Node<Key, Value>* node) const;
+    static size_t subtreeSize(Node<Key, Value>* node);
+    void rebuildScapegoat(Node<Key, Value>* newNode);
+    void rebuildSubtree(Node<Key, Value>* node);
+    Node<Key, Value>* buildBalanced(std::vector<Node<Key, Value>*>& nodes, int lo, int hi,
+                                    Node<Key, Value>* parent, int& height);
+    virtual void rebuiltNode(Node<Key, Value>* node, int leftHeight, int rightHeight);
+    virtual void augmentNode(Node<Key, Value>* node);
+    virtual void augmentPath(Node<Key, Value>* node);
+    static void splitTree(Node<Key, Value>* node, const Key& key, bool equalGoesLeft,
+                          Node<Key, Value>*& left, Node<Key, Value>*& right);
+    size_t destroySubtree(Node<Key, Value>* node);
+
+    // Node memory goes through the tree's allocator, rebound to the node type
+    template<typename NodeType, typename... Args>
+    NodeType* allocateNode(Args&&... args);
+    template<typename NodeType>
+    void deallocateNode(NodeType* node);
+    virtual void destroyNode(Node<Key, Value>* node);
+
+    // Copy/move support for this tree and derived trees
+    template<typename NodeType>
+    void copyFrom(const BinarySearchTree<Key, Value, Alloc>& other);
+    template<typename NodeType>
+    void cloneTree(const NodeType* source, Node<Key, Value>*& top);
+    virtual void swapTree(BinarySearchTree<Key, Value, Alloc>& other);
 
 
 protected:
     Node<Key, Value>* root_;
-    // You should not need other data members
+    size_t size_;       // number of items in the tree
+    double alpha_;      // scapegoat weight balance, 0 when rebuilding is off
+    size_t maxSize_;    // largest size since the last full rebuild
+    Alloc alloc_;
+    size_t bytes_;      // bytes of node storage currently allocated
+    // Hash index over every node; hashKey is the hasher enableHashIndex installs
+    template<typename Hash>
+    static size_t hashKey(const Key& key);
+    NodeHashIndex<Key, Value> index_;   // key -> node for every node, when enabled
+    mutable Node<Key, Value>* finger_;  // last node a finger search found, or NULL
+    bool fingerSearch_;                 // internalFind starts from finger_
 };
 
 /*
@@ -265,29 +623,31 @@ Begin implementations for the BinarySearchTree::iterator class.
 /**
 * Explicit constructor that initializes an iterator with a given node pointer.
 */
-template<class Key, class Value>
-BinarySearchTree<Key, Value>::iterator::iterator(Node<Key,Value> *ptr)
+template<class Key, class Value, class Alloc>
+BinarySearchTree<Key, Value, Alloc>::iterator::iterator(Node<Key,Value> *ptr, const BinarySearchTree<Key, Value, Alloc>* tree)
 {
     // TODO
     current_ = ptr; 
+    tree_ = tree;
 }
 
 /**
 * A default constructor that initializes the iterator to NULL.
 */
-template<class Key, class Value>
-BinarySearchTree<Key, Value>::iterator::iterator() 
+template<class Key, class Value, class Alloc>
+BinarySearchTree<Key, Value, Alloc>::iterator::iterator() 
 {
     // TODO
     current_ = NULL;
+    tree_ = NULL;
 }
 
 /**
 * Provides access to the item.
 */
-template<class Key, class Value>
+template<class Key, class Value, class Alloc>
 std::pair<const Key,Value> &
-BinarySearchTree<Key, Value>::iterator::operator*() const
+BinarySearchTree<Key, Value, Alloc>::iterator::operator*() const
 {
     return current_->getItem();
 }
@@ -295,9 +655,9 @@ BinarySearchTree<Key, Value>::iterator::operator*() const
 /**
 * Provides access to the address of the item.
 */
-template<class Key, class Value>
+template<class Key, class Value, class Alloc>
 std::pair<const Key,Value> *
-BinarySearchTree<Key, Value>::iterator::operator->() const
+BinarySearchTree<Key, Value, Alloc>::iterator::operator->() const
 {
     return &(current_->getItem());
 }
@@ -306,10 +666,10 @@ BinarySearchTree<Key, Value>::iterator::operator->() const
 * Checks if 'this' iterator's internals have the same value
 * as 'rhs'
 */
-template<class Key, class Value>
+template<class Key, class Value, class Alloc>
 bool
-BinarySearchTree<Key, Value>::iterator::operator==(
-    const BinarySearchTree<Key, Value>::iterator& rhs) const
+BinarySearchTree<Key, Value, Alloc>::iterator::operator==(
+    const BinarySearchTree<Key, Value, Alloc>::iterator& rhs) const
 {
     // TODO
     if(this->current_ == rhs.current_){
@@ -324,10 +684,10 @@ BinarySearchTree<Key, Value>::iterator::operator==(
 * Checks if 'this' iterator's internals have a different value
 * as 'rhs'
 */
-template<class Key, class Value>
+template<class Key, class Value, class Alloc>
 bool
-BinarySearchTree<Key, Value>::iterator::operator!=(
-    const BinarySearchTree<Key, Value>::iterator& rhs) const
+BinarySearchTree<Key, Value, Alloc>::iterator::operator!=(
+    const BinarySearchTree<Key, Value, Alloc>::iterator& rhs) const
 {
     // TODO
     if(this->current_ != rhs.current_){
@@ -343,12 +703,99 @@ BinarySearchTree<Key, Value>::iterator::operator!=(
 /**
 * Advances the iterator's location using an in-order sequencing
 */
-template<class Key, class Value>
-typename BinarySearchTree<Key, Value>::iterator&
-BinarySearchTree<Key, Value>::iterator::operator++()
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::iterator&
+BinarySearchTree<Key, Value, Alloc>::iterator::operator++()
 {
     // TODO
-    current_ = BinarySearchTree<Key, Value>::successor(current_);
+    current_ = tree_->nextNode(current_);
+    return *this;
+}
+
+/**
+* Moves the iterator back one item in-order. Decrementing end() gives the
+* largest item, which is what reverse iteration needs.
+*/
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::iterator&
+BinarySearchTree<Key, Value, Alloc>::iterator::operator--()
+{
+    if(current_ == NULL){
+      current_ = tree_->lastVisible(tree_->getLargestNode());
+    }
+    else{
+      current_ = tree_->prevNode(current_);
+    }
+    return *this;
+}
+
+/**
+* A default constructor for a singular const_iterator.
+*/
+template<class Key, class Value, class Alloc>
+BinarySearchTree<Key, Value, Alloc>::const_iterator::const_iterator() : it_()
+{
+
+}
+
+/**
+* Converting constructor from a mutable iterator.
+*/
+template<class Key, class Value, class Alloc>
+BinarySearchTree<Key, Value, Alloc>::const_iterator::const_iterator(const iterator& it) : it_(it)
+{
+
+}
+
+/**
+* Provides read-only access to the item.
+*/
+template<class Key, class Value, class Alloc>
+const std::pair<const Key,Value> &
+BinarySearchTree<Key, Value, Alloc>::const_iterator::operator*() const
+{
+    return *it_;
+}
+
+/**
+* Provides read-only access to the address of the item.
+*/
+template<class Key, class Value, class Alloc>
+const std::pair<const Key,Value> *
+BinarySearchTree<Key, Value, Alloc>::const_iterator::operator->() const
+{
+    return it_.operator->();
+}
+
+template<class Key, class Value, class Alloc>
+bool
+BinarySearchTree<Key, Value, Alloc>::const_iterator::operator==(
+    const BinarySearchTree<Key, Value, Alloc>::const_iterator& rhs) const
+{
+    return it_ == rhs.it_;
+}
+
+template<class Key, class Value, class Alloc>
+bool
+BinarySearchTree<Key, Value, Alloc>::const_iterator::operator!=(
+    const BinarySearchTree<Key, Value, Alloc>::const_iterator& rhs) const
+{
+    return it_ != rhs.it_;
+}
+
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::const_iterator&
+BinarySearchTree<Key, Value, Alloc>::const_iterator::operator++()
+{
+    ++it_;
+    return *this;
+}
+
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::const_iterator&
+BinarySearchTree<Key, Value, Alloc>::const_iterator::operator--()
+{
+    --it_;
     return *this;
 }
 
@@ -368,159 +815,546 @@ Begin implementations for the BinarySearchTree class.
 /**
 * Default constructor for a BinarySearchTree, which sets the root to NULL.
 */
-template<class Key, class Value>
-BinarySearchTree<Key, Value>::BinarySearchTree() 
+template<class Key, class Value, class Alloc>
+BinarySearchTree<Key, Value, Alloc>::BinarySearchTree() 
 {
     // TODO
     root_ = NULL;
+    size_ = 0;
+    alpha_ = 0;
+    maxSize_ = 0;
+    bytes_ = 0;
+    finger_ = NULL;
+    fingerSearch_ = false;
 }
 
-template<typename Key, typename Value>
-BinarySearchTree<Key, Value>::~BinarySearchTree()
+/**
+* Constructor taking an allocator instance, for stateful allocators such as
+* arenas. Nodes are allocated with a copy of it rebound to the node type.
+*/
+template<class Key, class Value, class Alloc>
+BinarySearchTree<Key, Value, Alloc>::BinarySearchTree(const Alloc& alloc) :
+    root_(NULL), size_(0), alpha_(0), maxSize_(0), alloc_(alloc), bytes_(0),
+    finger_(NULL), fingerSearch_(false)
 {
-    // TODO
-    clear();
+
 }
 
 /**
- * Returns true if tree is empty
+* Deep copy. The shape is cloned node for node in O(n), no re-inserting.
 */
-template<class Key, class Value>
-bool BinarySearchTree<Key, Value>::empty() const
+template<class Key, class Value, class Alloc>
+BinarySearchTree<Key, Value, Alloc>::BinarySearchTree(const BinarySearchTree<Key, Value, Alloc>& other) :
+    root_(NULL), size_(0), alpha_(0), maxSize_(0),
+    alloc_(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.alloc_)), bytes_(0),
+    finger_(NULL), fingerSearch_(false)
 {
-    return root_ == NULL;
+    copyFrom<Node<Key, Value> >(other);
 }
 
-template<typename Key, typename Value>
-void BinarySearchTree<Key, Value>::print() const
+/**
+* Move constructor; takes over other's nodes in O(1) and leaves it empty.
+*/
+template<class Key, class Value, class Alloc>
+BinarySearchTree<Key, Value, Alloc>::BinarySearchTree(BinarySearchTree<Key, Value, Alloc>&& other) :
+    root_(other.root_), size_(other.size_), alpha_(other.alpha_), maxSize_(other.maxSize_),
+    alloc_(std::move(other.alloc_)), bytes_(other.bytes_),
+    finger_(other.finger_), fingerSearch_(other.fingerSearch_)
 {
-    printRoot(root_);
-    std::cout << "\n";
+    other.root_ = NULL;
+    other.size_ = 0;
+    other.maxSize_ = 0;
+    other.bytes_ = 0;
+    other.finger_ = NULL;
+    index_.swap(other.index_);
 }
 
 /**
-* Returns an iterator to the "smallest" item in the tree
+* Copy assignment by copy and swap.
 */
-template<class Key, class Value>
-typename BinarySearchTree<Key, Value>::iterator
-BinarySearchTree<Key, Value>::begin() const
+template<class Key, class Value, class Alloc>
+BinarySearchTree<Key, Value, Alloc>&
+BinarySearchTree<Key, Value, Alloc>::operator=(const BinarySearchTree<Key, Value, Alloc>& other)
 {
-    BinarySearchTree<Key, Value>::iterator begin(getSmallestNode());
-    return begin;
+    if(this != &other){
+      BinarySearchTree<Key, Value, Alloc> copy(other);
+      swapTree(copy);
+    }
+    return *this;
 }
 
 /**
-* Returns an iterator whose value means INVALID
+* Move assignment in O(1): the trees trade contents and our old nodes are
+* freed whenever other is.
 */
-template<class Key, class Value>
-typename BinarySearchTree<Key, Value>::iterator
-BinarySearchTree<Key, Value>::end() const
+template<class Key, class Value, class Alloc>
+BinarySearchTree<Key, Value, Alloc>&
+BinarySearchTree<Key, Value, Alloc>::operator=(BinarySearchTree<Key, Value, Alloc>&& other)
 {
-    BinarySearchTree<Key, Value>::iterator end(NULL);
-    return end;
+    swapTree(other);
+    return *this;
 }
 
 /**
-* Returns an iterator to the item with the given key, k
-* or the end iterator if k does not exist in the tree
+* Exchanges the contents of two trees in O(1).
 */
-template<class Key, class Value>
-typename BinarySearchTree<Key, Value>::iterator
-BinarySearchTree<Key, Value>::find(const Key & k) const
+template<class Key, class Value, class Alloc>
+void BinarySearchTree<Key, Value, Alloc>::swap(BinarySearchTree<Key, Value, Alloc>& other)
 {
-    Node<Key, Value> *curr = internalFind(k);
-    BinarySearchTree<Key, Value>::iterator it(curr);
-    return it;
+    swapTree(other);
 }
 
-/**
- * @precondition The key exists in the map
- * Returns the value associated with the key
- */
-template<class Key, class Value>
-Value& BinarySearchTree<Key, Value>::operator[](const Key& key)
+template<typename Key, typename Value, typename Alloc>
+BinarySearchTree<Key, Value, Alloc>::~BinarySearchTree()
 {
-    Node<Key, Value> *curr = internalFind(key);
-    if(curr == NULL) throw std::out_of_range("Invalid key");
-    return curr->getValue();
+    // TODO
+    clear();
 }
-template<class Key, class Value>
-Value const & BinarySearchTree<Key, Value>::operator[](const Key& key) const
+
+/**
+ * Returns true if tree is empty
+*/
+template<class Key, class Value, class Alloc>
+bool BinarySearchTree<Key, Value, Alloc>::empty() const
 {
-    Node<Key, Value> *curr = internalFind(key);
-    if(curr == NULL) throw std::out_of_range("Invalid key");
-    return curr->getValue();
+    return size_ == 0;
 }
 
 /**
-* An insert method to insert into a Binary Search Tree.
-* The tree will not remain balanced when inserting.
-* Recall: If key is already in the tree, you should 
-* overwrite the current value with the updated value.
+ * Returns the number of items in the tree
 */
-template<class Key, class Value>
-void BinarySearchTree<Key, Value>::insert(const std::pair<const Key, Value> &keyValuePair)
+template<class Key, class Value, class Alloc>
+size_t BinarySearchTree<Key, Value, Alloc>::size() const
 {
-    // TODO
-    if(root_ == nullptr){ // create a new node if the tree is empty
-      root_ = new Node<Key, Value>(keyValuePair.first, keyValuePair.second, nullptr);
-      return;
-    }
-    Node<Key, Value>* current = root_;
-    Node<Key, Value>* parent = nullptr;
+    return size_;
+}
 
-    while(current != nullptr){ // traverse through to tree to figure out where to insert
-      parent = current;
+/**
+ * Returns the number of bytes of node storage the tree holds, plus the
+ * hash index's table when it is enabled
+*/
+template<class Key, class Value, class Alloc>
+size_t BinarySearchTree<Key, Value, Alloc>::memoryUsage() const
+{
+    return bytes_ + index_.memoryUsage();
+}
 
-      if(keyValuePair.first < current->getKey()){ // if it's less than, go left
-        current = current->getLeft();
-      }
-      else if(keyValuePair.first > current->getKey()){ // if it's greater than, go right
-        current = current->getRight();
-      }
-      else{ // otherwise update the value since the key already exists
-        current->setValue(keyValuePair.second);
-        return;
-      }
-    }
+/**
+ * Returns a copy of the tree's allocator
+*/
+template<class Key, class Value, class Alloc>
+Alloc BinarySearchTree<Key, Value, Alloc>::get_allocator() const
+{
+    return alloc_;
+}
 
-    Node<Key, Value>* newNode = new Node<Key, Value>(keyValuePair.first, keyValuePair.second, parent); // update for parent node
-    
-    if(keyValuePair.first < parent->getKey()){
-      parent->setLeft(newNode);
+/**
+* Turns on scapegoat rebuilding for insert/remove of the plain BST:
+* whenever an insert lands deeper than log(n)/log(1/alpha), the first
+* ancestor above it whose child holds more than alpha of its weight is
+* rebuilt into a perfectly balanced subtree. alpha must be in (0.5, 1); 0
+* turns it off. Nodes stay plain Nodes, the bookkeeping is two counters on
+* the tree. Trees that keep their own balance invariant refuse it.
+*/
+template<class Key, class Value, class Alloc>
+void BinarySearchTree<Key, Value, Alloc>::setScapegoatAlpha(double alpha)
+{
+    if(alpha != 0 && (alpha <= 0.5 || alpha >= 1)){
+      throw std::invalid_argument("scapegoat alpha must be in (0.5, 1)");
     }
-    else{
-      parent->setRight(newNode);
+    alpha_ = alpha;
+    maxSize_ = size_;
+    if(alpha_ != 0 && root_ != nullptr){ // start out balanced
+      rebuildSubtree(root_);
     }
 }
 
-
 /**
-* A remove method to remove a specific key from a Binary Search Tree.
-* Recall: The writeup specifies that if a node has 2 children you
-* should swap with the predecessor and then remove.
+* Turns on a hash index from key to node next to the tree, built here in
+* O(n) and then kept up to date as nodes are allocated and freed. While it
+* is on, every lookup that goes through internalFind (find, operator[],
+* remove, ...) and findBatch is one hash probe instead of a descent;
+* ordered iteration and range queries still walk the tree. Nodes never
+* change keys, so rotations, rebuilds and nodeSwap leave it valid. Costs
+* about 32 bytes per node, counted in memoryUsage(). Copies of the tree
+* keep the index. Hash defaults to std::hash<Key>.
 */
-template<typename Key, typename Value>
-void BinarySearchTree<Key, Value>::remove(const Key& key)
+template<class Key, class Value, class Alloc>
+template<typename Hash>
+void BinarySearchTree<Key, Value, Alloc>::enableHashIndex()
 {
-    // TODO
-    Node<Key, Value>* nodeRemove = internalFind(key); // find the node paired with the key
-    
-    if(nodeRemove == nullptr){ // if there's no node do nothing
+    index_.reset(&hashKey<Hash>);
+    if(root_ == nullptr){
       return;
     }
-
-    if(nodeRemove->getLeft() != nullptr && nodeRemove->getRight() != nullptr){ // if node has two children
-      Node<Key, Value>* predecessorNode = predecessor(nodeRemove); 
-      nodeSwap(nodeRemove, predecessorNode); // swap the node with its predecessor
+    Node<Key, Value>* node = root_;
+    while(node->getLeft() != nullptr){ // every node, tombstones included
+      node = node->getLeft();
     }
-
-    Node<Key, Value>* child = nullptr; // default child node to null in case we can't find
-    if(nodeRemove->getLeft() != nullptr){ // find any left children
-      child = nodeRemove->getLeft();
+    for(; node != nullptr; node = successor(node)){
+      index_.insert(node);
     }
-    else if(nodeRemove->getRight() != nullptr){ // find any right children
-      child = nodeRemove->getRight();
+}
+
+/**
+* Drops the hash index and frees its table; lookups descend the tree again.
+*/
+template<class Key, class Value, class Alloc>
+void BinarySearchTree<Key, Value, Alloc>::disableHashIndex()
+{
+    index_.reset(NULL);
+}
+
+template<class Key, class Value, class Alloc>
+bool BinarySearchTree<Key, Value, Alloc>::hashIndexEnabled() const
+{
+    return index_.enabled();
+}
+
+/**
+* The index's hash function for a given hasher type; a plain function so
+* the index needs no template parameter for it.
+*/
+template<typename Key, typename Value, typename Alloc>
+template<typename Hash>
+size_t BinarySearchTree<Key, Value, Alloc>::hashKey(const Key& key)
+{
+    return Hash()(key);
+}
+
+/**
+* Turns on finger search: internalFind (find, operator[], remove, ...)
+* starts from the last node it found instead of the root, climbing only
+* until it reaches an ancestor whose subtree must hold the key. For
+* sequential and nearby lookups that is usually a few levels, so the
+* average cost is well below a full descent. There is no O(log d) bound,
+* though: a finger on a long run of same-side edges (say the root's right
+* spine) climbs to the root even for its successor. Pays off when lookups
+* revisit nearby keys; on random keys the climb is wasted work. The finger makes const lookups write to the tree, so a tree with it
+* on must not be searched from several threads at once. The hash index,
+* when enabled, takes precedence.
+*/
+template<class Key, class Value, class Alloc>
+void BinarySearchTree<Key, Value, Alloc>::setFingerSearch(bool enabled)
+{
+    fingerSearch_ = enabled;
+    finger_ = NULL;
+}
+
+template<class Key, class Value, class Alloc>
+bool BinarySearchTree<Key, Value, Alloc>::fingerSearchEnabled() const
+{
+    return fingerSearch_;
+}
+
+template<typename Key, typename Value, typename Alloc>
+void BinarySearchTree<Key, Value, Alloc>::print() const
+{
+    printRoot(root_);
+    std::cout << "\n";
+}
+
+/**
+* Returns an iterator to the "smallest" item in the tree
+*/
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::iterator
+BinarySearchTree<Key, Value, Alloc>::begin() const
+{
+    BinarySearchTree<Key, Value, Alloc>::iterator begin(firstVisible(getSmallestNode()), this);
+    return begin;
+}
+
+/**
+* Returns an iterator whose value means INVALID
+*/
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::iterator
+BinarySearchTree<Key, Value, Alloc>::end() const
+{
+    BinarySearchTree<Key, Value, Alloc>::iterator end(NULL, this);
+    return end;
+}
+
+/**
+* Read-only versions of begin()/end().
+*/
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::const_iterator
+BinarySearchTree<Key, Value, Alloc>::cbegin() const
+{
+    return const_iterator(begin());
+}
+
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::const_iterator
+BinarySearchTree<Key, Value, Alloc>::cend() const
+{
+    return const_iterator(end());
+}
+
+/**
+* Returns a reverse iterator to the largest item in the tree
+*/
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::reverse_iterator
+BinarySearchTree<Key, Value, Alloc>::rbegin() const
+{
+    return reverse_iterator(end());
+}
+
+/**
+* Returns the reverse iterator one past the smallest item
+*/
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::reverse_iterator
+BinarySearchTree<Key, Value, Alloc>::rend() const
+{
+    return reverse_iterator(begin());
+}
+
+/**
+* Returns a reverse iterator to the largest item whose key is <= key, so
+* a descending scan from any point costs O(log n) to start.
+*/
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::reverse_iterator
+BinarySearchTree<Key, Value, Alloc>::rbegin(const Key& key) const
+{
+    return reverse_iterator(upper_bound(key));
+}
+
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::const_reverse_iterator
+BinarySearchTree<Key, Value, Alloc>::crbegin() const
+{
+    return const_reverse_iterator(cend());
+}
+
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::const_reverse_iterator
+BinarySearchTree<Key, Value, Alloc>::crend() const
+{
+    return const_reverse_iterator(cbegin());
+}
+
+/**
+* Returns an iterator to the item with the given key, k
+* or the end iterator if k does not exist in the tree
+*/
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::iterator
+BinarySearchTree<Key, Value, Alloc>::find(const Key & k) const
+{
+    Node<Key, Value> *curr = internalFind(k);
+    BinarySearchTree<Key, Value, Alloc>::iterator it(curr, this);
+    return it;
+}
+
+/**
+* Looks up count keys at once, storing find(keys[i]) in out[i]. Lookups run
+* in groups of 16 that advance one level per round, and each step prefetches
+* the child it moves to, so the cache misses of a group overlap instead of
+* being paid one after another.
+*/
+template<class Key, class Value, class Alloc>
+void BinarySearchTree<Key, Value, Alloc>::findBatch(const Key* keys, size_t count, iterator* out) const
+{
+    const size_t GROUP = 16;
+    Node<Key, Value>* current[GROUP];
+
+    if(index_.enabled()){ // no descents to interleave
+      for(size_t i = 0; i < count; ++i){
+        Node<Key, Value>* node = index_.find(keys[i]);
+        out[i] = (node != NULL && firstVisible(node) == node) ? makeIterator(node) : end();
+      }
+      return;
+    }
+
+    for(size_t base = 0; base < count; base += GROUP){
+      size_t groupSize = std::min(GROUP, count - base);
+      for(size_t i = 0; i < groupSize; ++i){
+        current[i] = root_;
+        out[base + i] = end();
+      }
+      size_t remaining = (root_ != NULL) ? groupSize : 0;
+
+      while(remaining > 0){ // one level of every unfinished lookup per round
+        for(size_t i = 0; i < groupSize; ++i){
+          Node<Key, Value>* node = current[i];
+          if(node == NULL){
+            continue;
+          }
+          const Key& key = keys[base + i];
+          if(key < node->getKey()){
+            node = node->getLeft();
+          }
+          else if(key > node->getKey()){
+            node = node->getRight();
+          }
+          else{ // found; a node hidden from iterators (a tombstone) counts as missing
+            if(firstVisible(node) == node){
+              out[base + i] = makeIterator(node);
+            }
+            node = NULL;
+          }
+          if(node == NULL){
+            --remaining;
+          }
+          else{
+            BST_PREFETCH(node);
+          }
+          current[i] = node;
+        }
+      }
+    }
+}
+
+/**
+* Returns an iterator to the first item whose key is not less than key
+*/
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::iterator
+BinarySearchTree<Key, Value, Alloc>::lower_bound(const Key& key) const
+{
+    Node<Key, Value>* currentNode = root_;
+    Node<Key, Value>* bound = NULL;
+    while(currentNode != NULL){
+      if(currentNode->getKey() < key){ // everything here and to the left is too small
+        currentNode = currentNode->getRight();
+      }
+      else{ // candidate, but look for a smaller one on the left
+        bound = currentNode;
+        currentNode = currentNode->getLeft();
+      }
+    }
+    return makeIterator(firstVisible(bound));
+}
+
+/**
+* Returns an iterator to the first item whose key is greater than key
+*/
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::iterator
+BinarySearchTree<Key, Value, Alloc>::upper_bound(const Key& key) const
+{
+    Node<Key, Value>* currentNode = root_;
+    Node<Key, Value>* bound = NULL;
+    while(currentNode != NULL){
+      if(key < currentNode->getKey()){ // candidate, but look for a smaller one on the left
+        bound = currentNode;
+        currentNode = currentNode->getLeft();
+      }
+      else{
+        currentNode = currentNode->getRight();
+      }
+    }
+    return makeIterator(firstVisible(bound));
+}
+
+/**
+* Wraps a node in an iterator; lets derived trees hand out iterators
+* without needing access to the iterator's constructor.
+*/
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::iterator
+BinarySearchTree<Key, Value, Alloc>::makeIterator(Node<Key, Value>* node) const
+{
+    BinarySearchTree<Key, Value, Alloc>::iterator it(node, this);
+    return it;
+}
+
+/**
+ * @precondition The key exists in the map
+ * Returns the value associated with the key
+ */
+template<class Key, class Value, class Alloc>
+Value& BinarySearchTree<Key, Value, Alloc>::operator[](const Key& key)
+{
+    Node<Key, Value> *curr = internalFind(key);
+    if(curr == NULL) throw std::out_of_range("Invalid key");
+    return curr->getValue();
+}
+template<class Key, class Value, class Alloc>
+Value const & BinarySearchTree<Key, Value, Alloc>::operator[](const Key& key) const
+{
+    Node<Key, Value> *curr = internalFind(key);
+    if(curr == NULL) throw std::out_of_range("Invalid key");
+    return curr->getValue();
+}
+
+/**
+* An insert method to insert into a Binary Search Tree.
+* The tree will not remain balanced when inserting.
+* Recall: If key is already in the tree, you should 
+* overwrite the current value with the updated value.
+*/
+template<class Key, class Value, class Alloc>
+void BinarySearchTree<Key, Value, Alloc>::insert(const std::pair<const Key, Value> &keyValuePair)
+{
+    // TODO
+    if(root_ == nullptr){ // create a new node if the tree is empty
+      root_ = allocateNode<Node<Key, Value> >(keyValuePair.first, keyValuePair.second, (Node<Key, Value>*)nullptr);
+      size_ = 1;
+      if(maxSize_ < size_) maxSize_ = size_;
+      return;
+    }
+    Node<Key, Value>* current = root_;
+    Node<Key, Value>* parent = nullptr;
+    Node<Key, Value>* candidate = nullptr; // smallest key >= the new key seen so far
+    int dir = 0;
+    int depth = 0;
+
+    while(current != nullptr){ // traverse through to tree to figure out where to insert, branch-free like internalFind
+      parent = current;
+      ++depth;
+      dir = current->getKey() < keyValuePair.first;
+      candidate = dir ? candidate : current;
+      current = current->getChild(dir);
+    }
+    if(candidate != nullptr && !(keyValuePair.first < candidate->getKey())){ // update the value since the key already exists
+      candidate->setValue(keyValuePair.second);
+      return;
+    }
+
+    Node<Key, Value>* newNode = allocateNode<Node<Key, Value> >(keyValuePair.first, keyValuePair.second, parent); // update for parent node
+    parent->setChild(dir, newNode); // the empty slot the descent ended on
+    ++size_;
+    if(maxSize_ < size_) maxSize_ = size_;
+
+    // scapegoat mode: too deep means some ancestor is out of weight balance
+    if(alpha_ != 0 && depth > std::log((double)size_) / std::log(1.0 / alpha_)){
+      rebuildScapegoat(newNode);
+    }
+}
+
+
+/**
+* A remove method to remove a specific key from a Binary Search Tree.
+* Recall: The writeup specifies that if a node has 2 children you
+* should swap with the predecessor and then remove.
+*/
+template<typename Key, typename Value, typename Alloc>
+void BinarySearchTree<Key, Value, Alloc>::remove(const Key& key)
+{
+    // TODO
+    Node<Key, Value>* nodeRemove = internalFind(key); // find the node paired with the key
+    
+    if(nodeRemove == nullptr){ // if there's no node do nothing
+      return;
+    }
+
+    if(nodeRemove->getLeft() != nullptr && nodeRemove->getRight() != nullptr){ // if node has two children
+      Node<Key, Value>* predecessorNode = predecessor(nodeRemove); 
+      nodeSwap(nodeRemove, predecessorNode); // swap the node with its predecessor
+    }
+
+    Node<Key, Value>* child = nullptr; // default child node to null in case we can't find
+    if(nodeRemove->getLeft() != nullptr){ // find any left children
+      child = nodeRemove->getLeft();
+    }
+    else if(nodeRemove->getRight() != nullptr){ // find any right children
+      child = nodeRemove->getRight();
     }
 
     Node<Key, Value>* parent = nodeRemove->getParent(); // reset the parent node to child node 
@@ -538,14 +1372,140 @@ void BinarySearchTree<Key, Value>::remove(const Key& key)
       parent->setRight(child);
     }
 
-    delete nodeRemove; // delete the node
+    destroyNode(nodeRemove); // delete the node
+    --size_;
+
+    // scapegoat mode: rebuild everything once enough nodes are gone
+    if(alpha_ != 0 && size_ < alpha_ * maxSize_){
+      if(root_ != nullptr) rebuildSubtree(root_);
+      maxSize_ = size_;
+    }
+}
+
+/**
+* Removes every item with lo <= key <= hi and returns how many there were.
+* The tree is split twice around the range, the part below lo and the part
+* above hi are joined under the largest key below lo, and the range is
+* freed in one sweep: O(depth + k) for k removed items, instead of k
+* separate removes. Does nothing if hi < lo.
+*/
+template<typename Key, typename Value, typename Alloc>
+size_t BinarySearchTree<Key, Value, Alloc>::eraseRange(const Key& lo, const Key& hi)
+{
+    if(root_ == nullptr || hi < lo){
+      return 0;
+    }
+    Node<Key, Value>* below;
+    Node<Key, Value>* rest;
+    Node<Key, Value>* range;
+    Node<Key, Value>* above;
+    splitTree(root_, lo, false, below, rest);
+    splitTree(rest, hi, true, range, above);
+
+    if(below == nullptr){
+      root_ = above;
+    }
+    else{ // the largest key below lo becomes the root, keeping the depth in check
+      Node<Key, Value>* top = below;
+      while(top->getRight() != nullptr){
+        top = top->getRight();
+      }
+      if(top != below){
+        top->getParent()->setRight(top->getLeft());
+        if(top->getLeft() != nullptr){
+          top->getLeft()->setParent(top->getParent());
+        }
+        top->setLeft(below);
+        below->setParent(top);
+      }
+      top->setRight(above);
+      if(above != nullptr){
+        above->setParent(top);
+      }
+      root_ = top;
+    }
+    if(root_ != nullptr){
+      root_->setParent(nullptr);
+    }
+
+    size_t removed = destroySubtree(range);
+    size_ -= removed;
+
+    // scapegoat mode: same rule as remove
+    if(alpha_ != 0 && size_ < alpha_ * maxSize_){
+      if(root_ != nullptr) rebuildSubtree(root_);
+      maxSize_ = size_;
+    }
+    return removed;
+}
+
+/**
+* Splits the subtree at node into left (keys below key, plus key itself if
+* equalGoesLeft) and right (the rest), walking down once without recursion.
+* Nodes keep their relative order, so no balance data is maintained.
+*/
+template<typename Key, typename Value, typename Alloc>
+void BinarySearchTree<Key, Value, Alloc>::splitTree(Node<Key, Value>* node, const Key& key, bool equalGoesLeft,
+                                                    Node<Key, Value>*& left, Node<Key, Value>*& right)
+{
+    left = nullptr;
+    right = nullptr;
+    Node<Key, Value>* leftTail = nullptr;   // where the next left piece hangs (as a right child)
+    Node<Key, Value>* rightTail = nullptr;  // where the next right piece hangs (as a left child)
+    while(node != nullptr){
+      bool goesLeft = node->getKey() < key || (equalGoesLeft && !(key < node->getKey()));
+      Node<Key, Value>* next;
+      if(goesLeft){ // node and its left subtree go left, keep splitting its right subtree
+        next = node->getRight();
+        if(leftTail == nullptr) left = node;
+        else leftTail->setRight(node);
+        node->setParent(leftTail);
+        leftTail = node;
+      }
+      else{
+        next = node->getLeft();
+        if(rightTail == nullptr) right = node;
+        else rightTail->setLeft(node);
+        node->setParent(rightTail);
+        rightTail = node;
+      }
+      node = next;
+    }
+    if(leftTail != nullptr) leftTail->setRight(nullptr);
+    if(rightTail != nullptr) rightTail->setLeft(nullptr);
+}
+
+/**
+* Frees every node of a detached subtree and returns how many there were.
+* Left children are rotated up until there are none, so no stack or parent
+* links are needed.
+*/
+template<typename Key, typename Value, typename Alloc>
+size_t BinarySearchTree<Key, Value, Alloc>::destroySubtree(Node<Key, Value>* node)
+{
+    size_t count = 0;
+    while(node != nullptr){
+      Node<Key, Value>* left = node->getLeft();
+      if(left != nullptr){ // rotate right in place
+        node->setLeft(left->getRight());
+        left->setRight(node);
+        node = left;
+      }
+      else{
+        Node<Key, Value>* right = node->getRight();
+        destroyNode(node);
+        ++count;
+        node = right;
+      }
+    }
+    return count;
 }
 
 
 
-template<class Key, class Value>
+template<class Key, class Value, class Alloc>
 Node<Key, Value>*
-BinarySearchTree<Key, Value>::predecessor(Node<Key, Value>* current)
+BinarySearchTree<Key, Value, Alloc>::predecessor(Node<Key, Value>* current)
 {
     // TODO
     if(current == nullptr){ // if the tree is empty
@@ -569,8 +1529,8 @@ BinarySearchTree<Key, Value>::predecessor(Node<Key, Value>* current)
 }
 
 // adding my helper function here
-template<typename Key, typename Value>
-Node<Key, Value>* BinarySearchTree<Key, Value>::successor(Node<Key, Value>* current)
+template<typename Key, typename Value, typename Alloc>
+Node<Key, Value>* BinarySearchTree<Key, Value, Alloc>::successor(Node<Key, Value>* current)
 {
   if(current == nullptr){ // if tree is empty
     return nullptr;
@@ -593,12 +1553,61 @@ Node<Key, Value>* BinarySearchTree<Key, Value>::successor(Node<Key, Value>* curr
 }
 
 
+/**
+* The in-order step used by iterators. Plain trees climb with successor();
+* trees that keep extra links can override it.
+*/
+template<typename Key, typename Value, typename Alloc>
+Node<Key, Value>* BinarySearchTree<Key, Value, Alloc>::nextNode(Node<Key, Value>* current) const
+{
+    return successor(current);
+}
+
+/**
+* The reverse in-order step used by iterators.
+*/
+template<typename Key, typename Value, typename Alloc>
+Node<Key, Value>* BinarySearchTree<Key, Value, Alloc>::prevNode(Node<Key, Value>* current) const
+{
+    return predecessor(current);
+}
+
+/**
+* Returns node, or the nearest node after it that iterators may stop at.
+* Every node is visible in a plain tree; trees that keep hidden nodes
+* around (AVLTree tombstones) override this and lastVisible().
+*/
+template<typename Key, typename Value, typename Alloc>
+Node<Key, Value>* BinarySearchTree<Key, Value, Alloc>::firstVisible(Node<Key, Value>* node) const
+{
+    return node;
+}
+
+/**
+* Returns node, or the nearest node before it that iterators may stop at.
+*/
+template<typename Key, typename Value, typename Alloc>
+Node<Key, Value>* BinarySearchTree<Key, Value, Alloc>::lastVisible(Node<Key, Value>* node) const
+{
+    return node;
+}
+
+/**
+* Whether node holds a live item, i.e. one iterators stop at. Tree dumps use
+* it to tell hidden nodes apart.
+*/
+template<typename Key, typename Value, typename Alloc>
+bool BinarySearchTree<Key, Value, Alloc>::isVisible(Node<Key, Value>*) const
+{
+    return true;
+}
+
 /**
 * A method to remove all contents of the tree and
 * reset the values in the tree for use again.
 */
-template<typename Key, typename Value>
-void BinarySearchTree<Key, Value>::clear()
+template<typename Key, typename Value, typename Alloc>
+void BinarySearchTree<Key, Value, Alloc>::clear()
 {
     // TODO
     if(root_ == nullptr){ // if the tree is empty do nothing 
@@ -609,7 +1618,7 @@ void BinarySearchTree<Key, Value>::clear()
     if(currentNode->getLeft() != nullptr){ // start with the left subtree 
       Node<Key, Value>* leftSubtree = currentNode->getLeft();
       root_ = leftSubtree; // move the root to the subtree
-      clear(); // use recursion to clear
+      BinarySearchTree<Key, Value, Alloc>::clear(); // use recursion to clear
       currentNode->setLeft(nullptr); // set the child to nullptr after deleting
       root_ = currentNode; // move the root back
     }
@@ -617,22 +1626,23 @@ void BinarySearchTree<Key, Value>::clear()
     if(currentNode->getRight() != nullptr){ // for clearing the right subtree
       Node<Key, Value>* rightSubtree = currentNode->getRight(); 
       root_ = rightSubtree; // move the root to the subtree
-      clear(); // use recursion to clear
+      BinarySearchTree<Key, Value, Alloc>::clear(); // use recursion to clear
       currentNode->setRight(nullptr); // set the child to nullptr after deleting
       root_ = currentNode; // move the root back
     }
 
-    delete root_; // finally delete the root after deleting the subtrees
+    destroyNode(root_); // finally delete the root after deleting the subtrees
     root_ = nullptr; // set to nullptr to make sure it's empty
+    size_ = 0;
 }
 
 
 /**
 * A helper function to find the smallest node in the tree.
 */
-template<typename Key, typename Value>
+template<typename Key, typename Value, typename Alloc>
 Node<Key, Value>*
-BinarySearchTree<Key, Value>::getSmallestNode() const
+BinarySearchTree<Key, Value, Alloc>::getSmallestNode() const
 {
     // TODO
     if(root_ == nullptr){ // if the tree is empty return nullptr
@@ -646,36 +1656,113 @@ BinarySearchTree<Key, Value>::getSmallestNode() const
     return currentNode; // return the node
 }
 
+/**
+* A helper function to find the largest node in the tree.
+*/
+template<typename Key, typename Value, typename Alloc>
+Node<Key, Value>*
+BinarySearchTree<Key, Value, Alloc>::getLargestNode() const
+{
+    if(root_ == nullptr){
+      return nullptr;
+    }
+
+    Node<Key, Value>* currentNode = root_;
+    while(currentNode->getRight() != nullptr){ // traverse right until a leaf is reached
+      currentNode = currentNode->getRight();
+    }
+    return currentNode;
+}
+
 /**
 * Helper function to find a node with given key, k and
 * return a pointer to it or NULL if no item with that key
 * exists
 */
-template<typename Key, typename Value>
-Node<Key, Value>* BinarySearchTree<Key, Value>::internalFind(const Key& key) const
+template<typename Key, typename Value, typename Alloc>
+Node<Key, Value>* BinarySearchTree<Key, Value, Alloc>::internalFind(const Key& key) const
 {
     // TODO
-    Node<Key, Value>* currentNode = root_; // set the current node 
+    if(index_.enabled()){ // one hash probe instead of the descent
+      return index_.find(key);
+    }
+    if(fingerSearch_){
+      return fingerFind(key);
+    }
+    return descendFrom(root_, key);
+}
 
-    while(currentNode != nullptr){ // traverse through the tree
-      if(key < currentNode->getKey()){ // search left if the key is smaller
-        currentNode = currentNode->getLeft();
+/**
+* Searches the subtree at start for key; start's subtree must be the only
+* place in the tree key could be. Returns NULL if it is not there.
+*/
+template<typename Key, typename Value, typename Alloc>
+Node<Key, Value>* BinarySearchTree<Key, Value, Alloc>::descendFrom(Node<Key, Value>* start, const Key& key)
+{
+    Node<Key, Value>* currentNode = start; // set the current node 
+    Node<Key, Value>* candidate = nullptr; // smallest key >= key seen so far
+
+    // no early exit on equality: every level is one compare whose result
+    // indexes the child, so there is no branch to mispredict on random keys
+    while(currentNode != nullptr){
+      int dir = currentNode->getKey() < key;
+      candidate = dir ? candidate : currentNode;
+      currentNode = currentNode->getChild(dir);
+    }
+    if(candidate != nullptr && !(key < candidate->getKey())){ // key found
+      return candidate;
+    }
+    return nullptr; // if key couldn't be found return null
+}
+
+/**
+* Finger search: climbs from finger_ until the key falls between a node
+* and its parent on the node's inner side, then descends from there. A
+* left child's right subtree holds exactly the keys between it and its
+* parent (and mirrored for a right child's left subtree), so each step up
+* needs one compare against the parent. Keys beyond a node on its outer
+* side cannot be placed that way, so those climbs may run to the root; the
+* descent from there is an ordinary full lookup. A hit becomes the new
+* finger; a miss keeps the old one.
+*/
+template<typename Key, typename Value, typename Alloc>
+Node<Key, Value>* BinarySearchTree<Key, Value, Alloc>::fingerFind(const Key& key) const
+{
+    Node<Key, Value>* node = (finger_ != NULL) ? finger_ : root_;
+    if(node == NULL){
+      return NULL;
+    }
+    while(true){
+      int goRight = node->getKey() < key;
+      if(!goRight && !(key < node->getKey())){ // the climb itself reached it
+        finger_ = node;
+        return node;
       }
-      else if(key > currentNode->getKey()){ // search right if the key is larger
-        currentNode = currentNode->getRight();
+      Node<Key, Value>* parent = node->getParent();
+      if(parent == NULL){
+        break;
       }
-      else{ // otherwise the key has been found and return it
-        return currentNode;
+      // computed without branches, so the loop exit is the only one taken
+      int isRight = (parent->getChild(1) == node);
+      int belowParent = key < parent->getKey();
+      int aboveParent = parent->getKey() < key;
+      if((goRight ^ isRight) & ((goRight & belowParent) | ((1 - goRight) & aboveParent))){
+        break; // key is between node and parent, so under node
       }
+      node = parent;
     }
-    return nullptr; // if key couldn't be found return null
+    Node<Key, Value>* found = descendFrom(node, key);
+    if(found != NULL){
+      finger_ = found;
+    }
+    return found;
 }
 
 /**
  * Return true iff the BST is balanced.
  */
-template<typename Key, typename Value>
-bool BinarySearchTree<Key, Value>::isBalanced() const
+template<typename Key, typename Value, typename Alloc>
+bool BinarySearchTree<Key, Value, Alloc>::isBalanced() const
 {
     // TODO
     if(balanceHelper(root_) != -1){
@@ -687,8 +1774,8 @@ bool BinarySearchTree<Key, Value>::isBalanced() const
 }
 
 // adding my helper function
-template <typename Key, typename Value>
-int BinarySearchTree<Key, Value>::balanceHelper(Node<Key, Value>* node) const
+template<typename Key, typename Value, typename Alloc>
+int BinarySearchTree<Key, Value, Alloc>::balanceHelper(Node<Key, Value>* node) const
 {
   if(node == nullptr){ // if the tree is empty
     return 0;
@@ -714,8 +1801,8 @@ int BinarySearchTree<Key, Value>::balanceHelper(Node<Key, Value>* node) const
 
 
 
-template<typename Key, typename Value>
-void BinarySearchTree<Key, Value>::nodeSwap( Node<Key,Value>* n1, Node<Key,Value>* n2)
+template<typename Key, typename Value, typename Alloc>
+void BinarySearchTree<Key, Value, Alloc>::nodeSwap( Node<Key,Value>* n1, Node<Key,Value>* n2)
 {
     if((n1 == n2) || (n1 == NULL) || (n2 == NULL) ) {
         return;
@@ -798,6 +1885,394 @@ void BinarySearchTree<Key, Value>::nodeSwap( Node<Key,Value>* n1, Node<Key,Value
 
 }
 
+/**
+* Counts the nodes in the subtree rooted at node, walking parent links
+* instead of recursing so degenerate subtrees are fine.
+*/
+template<typename Key, typename Value, typename Alloc>
+size_t BinarySearchTree<Key, Value, Alloc>::subtreeSize(Node<Key, Value>* node)
+{
+    if(node == nullptr){
+      return 0;
+    }
+    size_t count = 0;
+    Node<Key, Value>* stop = node->getParent();
+    Node<Key, Value>* current = node;
+    while(current->getLeft() != nullptr){ // start at the smallest node in the subtree
+      current = current->getLeft();
+    }
+    while(current != stop){ // in-order walk that ends when we climb out of the subtree
+      ++count;
+      if(current->getRight() != nullptr){
+        current = current->getRight();
+        while(current->getLeft() != nullptr){
+          current = current->getLeft();
+        }
+      }
+      else{
+        Node<Key, Value>* parentNode = current->getParent();
+        while(parentNode != stop && current == parentNode->getRight()){
+          current = parentNode;
+          parentNode = parentNode->getParent();
+        }
+        current = parentNode;
+      }
+    }
+    return count;
+}
+
+/**
+* Climbs from a freshly inserted node to the first ancestor that is not
+* alpha weight balanced and rebuilds it.
+*/
+template<typename Key, typename Value, typename Alloc>
+void BinarySearchTree<Key, Value, Alloc>::rebuildScapegoat(Node<Key, Value>* newNode)
+{
+    Node<Key, Value>* child = newNode;
+    size_t childSize = 1;
+    while(child->getParent() != nullptr){
+      Node<Key, Value>* parentNode = child->getParent();
+      Node<Key, Value>* sibling = (parentNode->getLeft() == child) ? parentNode->getRight() : parentNode->getLeft();
+      size_t parentSize = childSize + 1 + subtreeSize(sibling);
+      if(childSize > alpha_ * parentSize){ // found the scapegoat
+        rebuildSubtree(parentNode);
+        return;
+      }
+      child = parentNode;
+      childSize = parentSize;
+    }
+}
+
+/**
+* Relinks the subtree rooted at node into perfect balance in O(size) time.
+* No nodes are allocated or freed.
+*/
+template<typename Key, typename Value, typename Alloc>
+void BinarySearchTree<Key, Value, Alloc>::rebuildSubtree(Node<Key, Value>* node)
+{
+    Node<Key, Value>* parentNode = node->getParent();
+    bool wasLeft = (parentNode != nullptr && parentNode->getLeft() == node);
+
+    std::vector<Node<Key, Value>*> nodes;
+    nodes.reserve(subtreeSize(node));
+    Node<Key, Value>* current = node;
+    while(current->getLeft() != nullptr){
+      current = current->getLeft();
+    }
+    while(current != parentNode){ // same in-order walk as subtreeSize, collecting nodes
+      nodes.push_back(current);
+      if(current->getRight() != nullptr){
+        current = current->getRight();
+        while(current->getLeft() != nullptr){
+          current = current->getLeft();
+        }
+      }
+      else{
+        Node<Key, Value>* up = current->getParent();
+        while(up != parentNode && current == up->getRight()){
+          current = up;
+          up = up->getParent();
+        }
+        current = up;
+      }
+    }
+
+    int height;
+    Node<Key, Value>* top = buildBalanced(nodes, 0, (int)nodes.size() - 1, parentNode, height);
+    if(parentNode == nullptr){
+      root_ = top;
+    }
+    else if(wasLeft){
+      parentNode->setLeft(top);
+    }
+    else{
+      parentNode->setRight(top);
+    }
+}
+
+/**
+* Links nodes[lo..hi] (sorted) into a perfectly balanced subtree under parent,
+* returning its root and storing its height.
+*/
+template<typename Key, typename Value, typename Alloc>
+Node<Key, Value>* BinarySearchTree<Key, Value, Alloc>::buildBalanced(std::vector<Node<Key, Value>*>& nodes, int lo, int hi,
+                                                              Node<Key, Value>* parent, int& height)
+{
+    if(lo > hi){
+      height = 0;
+      return nullptr;
+    }
+    int mid = lo + (hi - lo + 1) / 2; // upper middle so the left side is never taller
+    Node<Key, Value>* node = nodes[mid];
+    int leftHeight, rightHeight;
+    node->setParent(parent);
+    node->setLeft(buildBalanced(nodes, lo, mid - 1, node, leftHeight));
+    node->setRight(buildBalanced(nodes, mid + 1, hi, node, rightHeight));
+    height = 1 + std::max(leftHeight, rightHeight);
+    rebuiltNode(node, leftHeight, rightHeight);
+    augmentNode(node);
+    return node;
+}
+
+/**
+* Called by buildBalanced for each relinked node once both subtrees are in
+* place, so trees that keep per-node balance data can fill it in.
+*/
+template<typename Key, typename Value, typename Alloc>
+void BinarySearchTree<Key, Value, Alloc>::rebuiltNode(Node<Key, Value>*, int, int)
+{
+
+}
+
+/**
+* Recomputes whatever a tree caches about node's subtree (a max endpoint, a
+* sum, ...) from node and its children's cached data. Called by rotations
+* and rebuilds for every node whose subtree changed; plain trees cache
+* nothing.
+*/
+template<typename Key, typename Value, typename Alloc>
+void BinarySearchTree<Key, Value, Alloc>::augmentNode(Node<Key, Value>*)
+{
+
+}
+
+/**
+* Called once after an insert or remove with the lowest node whose subtree
+* changed; every changed subtree is then on the path from it to the root.
+* Augmented trees override this to run augmentNode up that path.
+*/
+template<typename Key, typename Value, typename Alloc>
+void BinarySearchTree<Key, Value, Alloc>::augmentPath(Node<Key, Value>*)
+{
+
+}
+
+/**
+* Allocates and constructs a node of the given type with the tree's
+* allocator, and charges its size to memoryUsage().
+*/
+template<typename Key, typename Value, typename Alloc>
+template<typename NodeType, typename... Args>
+NodeType* BinarySearchTree<Key, Value, Alloc>::allocateNode(Args&&... args)
+{
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<NodeType> NodeAlloc;
+    typedef std::allocator_traits<NodeAlloc> NodeTraits;
+    NodeAlloc nodeAlloc(alloc_);
+    NodeType* node = NodeTraits::allocate(nodeAlloc, 1);
+    try{
+      NodeTraits::construct(nodeAlloc, node, std::forward<Args>(args)...);
+    }
+    catch(...){
+      NodeTraits::deallocate(nodeAlloc, node, 1);
+      throw;
+    }
+    bytes_ += sizeof(NodeType);
+    if(index_.enabled()){
+      index_.insert(node);
+    }
+    return node;
+}
+
+/**
+* Destroys and frees a node allocated by allocateNode<NodeType>.
+*/
+template<typename Key, typename Value, typename Alloc>
+template<typename NodeType>
+void BinarySearchTree<Key, Value, Alloc>::deallocateNode(NodeType* node)
+{
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<NodeType> NodeAlloc;
+    typedef std::allocator_traits<NodeAlloc> NodeTraits;
+    NodeAlloc nodeAlloc(alloc_);
+    if(index_.enabled()){
+      index_.erase(node);
+    }
+    if(finger_ == node){
+      finger_ = NULL;
+    }
+    NodeTraits::destroy(nodeAlloc, node);
+    NodeTraits::deallocate(nodeAlloc, node, 1);
+    bytes_ -= sizeof(NodeType);
+}
+
+/**
+* Frees any node of this tree. Trees with their own node type override this
+* to free it as that type; they must also call clear() in their destructor,
+* since the base destructor can no longer reach the override.
+*/
+template<typename Key, typename Value, typename Alloc>
+void BinarySearchTree<Key, Value, Alloc>::destroyNode(Node<Key, Value>* node)
+{
+    deallocateNode(node);
+}
+
+/**
+* Replaces the (empty) contents of this tree with a clone of other's,
+* allocating every node as NodeType. Derived trees call this from their copy
+* constructors with their own node type.
+*/
+template<typename Key, typename Value, typename Alloc>
+template<typename NodeType>
+void BinarySearchTree<Key, Value, Alloc>::copyFrom(const BinarySearchTree<Key, Value, Alloc>& other)
+{
+    if(other.index_.enabled()){ // the clones are indexed as they are allocated
+      index_.reset(other.index_.hashFunction());
+    }
+    try{
+      cloneTree(static_cast<const NodeType*>(other.root_), root_);
+    }
+    catch(...){ // free whatever was cloned before the allocator gave up
+      clear();
+      throw;
+    }
+    size_ = other.size_;
+    alpha_ = other.alpha_;
+    maxSize_ = other.maxSize_;
+    fingerSearch_ = other.fingerSearch_;
+}
+
+/**
+* Clones the subtree at source into top, in preorder, walking parent links on
+* both sides so deep trees need no recursion. Each node is copy constructed,
+* which carries over balances, colors, etc.; the links are then redone.
+* top is set first and every copy is linked in as soon as it exists, so if an
+* allocation throws, what was built so far is a valid tree under top.
+*/
+template<typename Key, typename Value, typename Alloc>
+template<typename NodeType>
+void BinarySearchTree<Key, Value, Alloc>::cloneTree(const NodeType* source, Node<Key, Value>*& top)
+{
+    top = nullptr;
+    if(source == nullptr){
+      return;
+    }
+
+    NodeType* copy = allocateNode<NodeType>(*source);
+    copy->setParent(nullptr);
+    copy->setLeft(nullptr);
+    copy->setRight(nullptr);
+    top = copy;
+
+    const Node<Key, Value>* from = source;
+    Node<Key, Value>* to = copy;
+    while(true){
+      if(from->getLeft() != nullptr && to->getLeft() == nullptr){ // copy the left child next
+        NodeType* child = allocateNode<NodeType>(*static_cast<const NodeType*>(from->getLeft()));
+        child->setParent(to);
+        child->setLeft(nullptr);
+        child->setRight(nullptr);
+        to->setLeft(child);
+        from = from->getLeft();
+        to = child;
+      }
+      else if(from->getRight() != nullptr && to->getRight() == nullptr){ // then the right child
+        NodeType* child = allocateNode<NodeType>(*static_cast<const NodeType*>(from->getRight()));
+        child->setParent(to);
+        child->setLeft(nullptr);
+        child->setRight(nullptr);
+        to->setRight(child);
+        from = from->getRight();
+        to = child;
+      }
+      else if(from == source){ // both subtrees of the top are done
+        break;
+      }
+      else{ // this subtree is done, go back up on both sides
+        from = from->getParent();
+        to = to->getParent();
+      }
+    }
+}
+
+/**
+* Swaps every member with other. Both must be the same kind of tree; derived
+* trees with members of their own override this and call it first.
+*/
+template<typename Key, typename Value, typename Alloc>
+void BinarySearchTree<Key, Value, Alloc>::swapTree(BinarySearchTree<Key, Value, Alloc>& other)
+{
+    std::swap(root_, other.root_);
+    std::swap(size_, other.size_);
+    std::swap(alpha_, other.alpha_);
+    std::swap(maxSize_, other.maxSize_);
+    std::swap(alloc_, other.alloc_);
+    std::swap(bytes_, other.bytes_);
+    index_.swap(other.index_);
+    std::swap(finger_, other.finger_);
+    std::swap(fingerSearch_, other.fingerSearch_);
+}
+
+/**
+* Rotates node down to the left so that its right child takes its place.
+* Parent pointers and the root are kept consistent; balance data, if any,
+* is left to the caller.
+*/
+template<typename Key, typename Value, typename Alloc>
+void BinarySearchTree<Key, Value, Alloc>::rotateLeft(Node<Key, Value>* node)
+{
+  Node<Key, Value>* rightChild = node->getRight(); // get the right child of the node 
+  if(!rightChild){ // if it doesn't exist then do nothing 
+    return;
+  }
+
+  Node<Key, Value>* parentNode = node->getParent();
+  node->setRight(rightChild->getLeft()); // reset the right pointer 
+
+  if(rightChild->getLeft()){ // if there is a subtree then also reset its parent 
+    rightChild->getLeft()->setParent(node);
+  }
+
+  rightChild->setLeft(node); // resetting node pointers 
+  node->setParent(rightChild);
+  rightChild->setParent(parentNode);
+
+  if(parentNode == nullptr){ // if the node was the root then reset the root 
+    root_ = rightChild;
+  }
+  else if(parentNode->getLeft() == node){ // node was left child 
+    parentNode->setLeft(rightChild);
+  }
+  else{ // node was right child 
+    parentNode->setRight(rightChild); 
+  }
+  augmentNode(node); // node is now below rightChild
+  augmentNode(rightChild);
+}
+
+/**
+* Rotates node down to the right so that its left child takes its place.
+*/
+template<typename Key, typename Value, typename Alloc>
+void BinarySearchTree<Key, Value, Alloc>::rotateRight(Node<Key, Value>* node)
+{
+  Node<Key, Value>* leftChild = node->getLeft(); // get the left child of the node 
+  if(!leftChild){ // do nothing if it doesn't exist 
+    return;
+  }
+
+  Node<Key, Value>* parentNode = node->getParent();
+  node->setLeft(leftChild->getRight());// reset the left pointer 
+
+  if(leftChild->getRight()){ // if there is a subtree then also reset its parent 
+    leftChild->getRight()->setParent(node);
+  }
+
+  leftChild->setRight(node); // resetting node pointers 
+  node->setParent(leftChild);
+  leftChild->setParent(parentNode);
+
+  if(parentNode == nullptr){ // if the node was the root then reset the root 
+    root_ = leftChild;
+  }
+  else if(parentNode->getLeft() == node){ // if the node was a left child 
+    parentNode->setLeft(leftChild);
+  }
+  else{ // if the node was a right child 
+    parentNode->setRight(leftChild);
+  }
+  augmentNode(node); // node is now below leftChild
+  augmentNode(leftChild);
+}
+
 /**
  * Lastly, we are providing you with a print function,
    BinarySearchTree::printRoot().
@@ -0,0 +1,378 @@
+#ifndef BUFFEREDBST_H
+#define BUFFEREDBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include "bst.h"
+#include "avlbst.h"
+
+/**
+* A front end that absorbs bursts of inserts into a small sorted buffer and
+* merges them into the underlying tree in batches. The buffer is one
+* contiguous vector that stays in cache, so an insert costs a binary search
+* and a short memmove instead of a cold descent plus rotations; the batch
+* merge then walks the tree in key order, so consecutive descents share most
+* of their path.
+*
+* Buffered entries shadow the tree: find() and iteration look at both and a
+* buffered value wins over the tree's value for the same key. Any insert or
+* remove invalidates iterators.
+*/
+template <class Key, class Value, class Tree = AVLTree<Key, Value> >
+class BufferedTree
+{
+public:
+    explicit BufferedTree(size_t bufferSize = 64);
+    void insert(const std::pair<const Key, Value>& new_item);
+    void remove(const Key& key);
+    void flush();
+    void clear();
+    bool empty() const;
+    size_t size() const;
+    size_t bufferSize() const;
+    void setBufferSize(size_t bufferSize);
+    const Tree& tree() const;
+
+    /**
+    * Read-only forward iterator over the merged contents. Dereferencing gives
+    * a pair of references, since items live in either the buffer or a node.
+    */
+    class iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::pair<const Key, Value> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::pair<const Key&, const Value&> reference;
+
+        // Lets it->first work on the pair of references.
+        class pointer
+        {
+        public:
+            pointer(const reference& item) : item_(item) {}
+            const reference* operator->() const { return &item_; }
+        private:
+            reference item_;
+        };
+
+        iterator();
+
+        reference operator*() const;
+        pointer operator->() const;
+
+        bool operator==(const iterator& rhs) const;
+        bool operator!=(const iterator& rhs) const;
+
+        iterator& operator++();
+
+    protected:
+        friend class BufferedTree<Key, Value, Tree>;
+        iterator(const BufferedTree<Key, Value, Tree>* owner, size_t bufferPos,
+                 typename Tree::iterator treeIt);
+        bool onBuffer() const;
+
+        const BufferedTree<Key, Value, Tree>* owner_;
+        size_t bufferPos_;
+        typename Tree::iterator treeIt_;
+    };
+
+    iterator begin() const;
+    iterator end() const;
+    iterator find(const Key& key) const;
+    iterator lower_bound(const Key& key) const;
+    Value const & operator[](const Key& key) const;
+
+protected:
+    size_t bufferLowerBound(const Key& key) const;
+
+    Tree tree_;
+    std::vector<std::pair<Key, Value> > buffer_;  // sorted by key, no duplicates
+    size_t bufferSize_;                           // flush once this many items are buffered
+};
+
+/*
+  -------------------------------------------------
+  Begin implementations for the BufferedTree::iterator class.
+  -------------------------------------------------
+*/
+
+template<class Key, class Value, class Tree>
+BufferedTree<Key, Value, Tree>::iterator::iterator() : owner_(NULL), bufferPos_(0), treeIt_()
+{
+
+}
+
+template<class Key, class Value, class Tree>
+BufferedTree<Key, Value, Tree>::iterator::iterator(const BufferedTree<Key, Value, Tree>* owner, size_t bufferPos,
+                                                   typename Tree::iterator treeIt) :
+    owner_(owner), bufferPos_(bufferPos), treeIt_(treeIt)
+{
+
+}
+
+/**
+* True if the current item comes from the buffer: the buffer's next key is
+* not larger than the tree's (on a tie the buffer shadows the tree).
+*/
+template<class Key, class Value, class Tree>
+bool BufferedTree<Key, Value, Tree>::iterator::onBuffer() const
+{
+    if(bufferPos_ == owner_->buffer_.size()){
+      return false;
+    }
+    return treeIt_ == owner_->tree_.end() || !(treeIt_->first < owner_->buffer_[bufferPos_].first);
+}
+
+template<class Key, class Value, class Tree>
+typename BufferedTree<Key, Value, Tree>::iterator::reference
+BufferedTree<Key, Value, Tree>::iterator::operator*() const
+{
+    if(onBuffer()){
+      const std::pair<Key, Value>& item = owner_->buffer_[bufferPos_];
+      return reference(item.first, item.second);
+    }
+    return reference(treeIt_->first, treeIt_->second);
+}
+
+template<class Key, class Value, class Tree>
+typename BufferedTree<Key, Value, Tree>::iterator::pointer
+BufferedTree<Key, Value, Tree>::iterator::operator->() const
+{
+    return pointer(**this);
+}
+
+template<class Key, class Value, class Tree>
+bool BufferedTree<Key, Value, Tree>::iterator::operator==(const iterator& rhs) const
+{
+    return bufferPos_ == rhs.bufferPos_ && treeIt_ == rhs.treeIt_;
+}
+
+template<class Key, class Value, class Tree>
+bool BufferedTree<Key, Value, Tree>::iterator::operator!=(const iterator& rhs) const
+{
+    return !(*this == rhs);
+}
+
+/**
+* Steps whichever side the current item came from; a tree item shadowed by
+* the buffer is stepped over together with it.
+*/
+template<class Key, class Value, class Tree>
+typename BufferedTree<Key, Value, Tree>::iterator&
+BufferedTree<Key, Value, Tree>::iterator::operator++()
+{
+    if(onBuffer()){
+      if(treeIt_ != owner_->tree_.end() && !(owner_->buffer_[bufferPos_].first < treeIt_->first)){
+        ++treeIt_;
+      }
+      ++bufferPos_;
+    }
+    else{
+      ++treeIt_;
+    }
+    return *this;
+}
+
+/*
+  -------------------------------------------------
+  End implementations for the BufferedTree::iterator class.
+  -------------------------------------------------
+*/
+
+/**
+* bufferSize is the number of inserts collected before a merge; 0 sends
+* every insert straight to the tree.
+*/
+template<class Key, class Value, class Tree>
+BufferedTree<Key, Value, Tree>::BufferedTree(size_t bufferSize) : tree_(), buffer_(), bufferSize_(bufferSize)
+{
+    buffer_.reserve(bufferSize_);
+}
+
+/**
+* Adds or updates an item in the buffer, merging the buffer into the tree
+* once it is full.
+*/
+template<class Key, class Value, class Tree>
+void BufferedTree<Key, Value, Tree>::insert(const std::pair<const Key, Value>& new_item)
+{
+    if(bufferSize_ == 0){
+      tree_.insert(new_item);
+      return;
+    }
+
+    size_t pos = bufferLowerBound(new_item.first);
+    if(pos < buffer_.size() && !(new_item.first < buffer_[pos].first)){ // already buffered, update it
+      buffer_[pos].second = new_item.second;
+      return;
+    }
+    buffer_.insert(buffer_.begin() + pos, std::pair<Key, Value>(new_item.first, new_item.second));
+    if(buffer_.size() >= bufferSize_){
+      flush();
+    }
+}
+
+/**
+* Removes the key from both the buffer and the tree.
+*/
+template<class Key, class Value, class Tree>
+void BufferedTree<Key, Value, Tree>::remove(const Key& key)
+{
+    size_t pos = bufferLowerBound(key);
+    if(pos < buffer_.size() && !(key < buffer_[pos].first)){
+      buffer_.erase(buffer_.begin() + pos);
+    }
+    tree_.remove(key);
+}
+
+/**
+* Merges every buffered item into the tree, in key order.
+*/
+template<class Key, class Value, class Tree>
+void BufferedTree<Key, Value, Tree>::flush()
+{
+    for(size_t i = 0; i < buffer_.size(); ++i){
+      tree_.insert(std::pair<const Key, Value>(buffer_[i].first, buffer_[i].second));
+    }
+    buffer_.clear();
+}
+
+template<class Key, class Value, class Tree>
+void BufferedTree<Key, Value, Tree>::clear()
+{
+    buffer_.clear();
+    tree_.clear();
+}
+
+template<class Key, class Value, class Tree>
+bool BufferedTree<Key, Value, Tree>::empty() const
+{
+    return buffer_.empty() && tree_.empty();
+}
+
+/**
+* Number of distinct keys. Buffered keys that also sit in the tree are only
+* counted once, which costs a lookup per buffered item.
+*/
+template<class Key, class Value, class Tree>
+size_t BufferedTree<Key, Value, Tree>::size() const
+{
+    size_t count = tree_.size();
+    for(size_t i = 0; i < buffer_.size(); ++i){
+      if(tree_.find(buffer_[i].first) == tree_.end()){
+        ++count;
+      }
+    }
+    return count;
+}
+
+template<class Key, class Value, class Tree>
+size_t BufferedTree<Key, Value, Tree>::bufferSize() const
+{
+    return bufferSize_;
+}
+
+/**
+* Changes how many inserts are buffered; merges right away if the buffer
+* already holds that many.
+*/
+template<class Key, class Value, class Tree>
+void BufferedTree<Key, Value, Tree>::setBufferSize(size_t bufferSize)
+{
+    bufferSize_ = bufferSize;
+    if(buffer_.size() >= bufferSize_){
+      flush();
+    }
+    buffer_.reserve(bufferSize_);
+}
+
+/**
+* The underlying tree; it lacks whatever is still buffered.
+*/
+template<class Key, class Value, class Tree>
+const Tree& BufferedTree<Key, Value, Tree>::tree() const
+{
+    return tree_;
+}
+
+template<class Key, class Value, class Tree>
+typename BufferedTree<Key, Value, Tree>::iterator
+BufferedTree<Key, Value, Tree>::begin() const
+{
+    return iterator(this, 0, tree_.begin());
+}
+
+template<class Key, class Value, class Tree>
+typename BufferedTree<Key, Value, Tree>::iterator
+BufferedTree<Key, Value, Tree>::end() const
+{
+    return iterator(this, buffer_.size(), tree_.end());
+}
+
+/**
+* Returns an iterator to the item with the given key or end(). The buffer is
+* searched first, since it holds the newest value.
+*/
+template<class Key, class Value, class Tree>
+typename BufferedTree<Key, Value, Tree>::iterator
+BufferedTree<Key, Value, Tree>::find(const Key& key) const
+{
+    size_t pos = bufferLowerBound(key);
+    if(pos < buffer_.size() && !(key < buffer_[pos].first)){
+      return iterator(this, pos, tree_.lower_bound(key));
+    }
+    typename Tree::iterator treeIt = tree_.find(key);
+    if(treeIt == tree_.end()){
+      return end();
+    }
+    return iterator(this, pos, treeIt);
+}
+
+/**
+* Returns an iterator to the first item whose key is not less than key
+*/
+template<class Key, class Value, class Tree>
+typename BufferedTree<Key, Value, Tree>::iterator
+BufferedTree<Key, Value, Tree>::lower_bound(const Key& key) const
+{
+    return iterator(this, bufferLowerBound(key), tree_.lower_bound(key));
+}
+
+/**
+ * @precondition The key exists in the map
+ * Returns the value associated with the key
+ */
+template<class Key, class Value, class Tree>
+Value const & BufferedTree<Key, Value, Tree>::operator[](const Key& key) const
+{
+    iterator it = find(key);
+    if(it == end()) throw std::out_of_range("Invalid key");
+    return it->second;
+}
+
+/**
+* Index of the first buffered item whose key is not less than key.
+*/
+template<class Key, class Value, class Tree>
+size_t BufferedTree<Key, Value, Tree>::bufferLowerBound(const Key& key) const
+{
+    size_t lo = 0, hi = buffer_.size();
+    while(lo < hi){
+      size_t mid = lo + (hi - lo) / 2;
+      if(buffer_[mid].first < key){
+        lo = mid + 1;
+      }
+      else{
+        hi = mid;
+      }
+    }
+    return lo;
+}
+
+#endif
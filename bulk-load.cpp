@@ -0,0 +1,96 @@
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include "bst.h"
+#include "avlbst.h"
+#include "bulkload.h"
+
+using namespace std;
+
+// Loads a file of (long long, long long) records into an AVLTree and
+// reports where the time went and the overall MB/s.
+//
+// usage: bulk-load <file> [text|binary] [threads] [delimiter]
+//        bulk-load --generate <file> <records> [text|binary] [sorted|shuffled]
+//   threads defaults to every hardware thread, the delimiter to ','
+//   --generate writes a test file with keys 0..records-1 and value 3 * key
+
+int usage()
+{
+    cerr << "usage: bulk-load <file> [text|binary] [threads] [delimiter]" << endl
+         << "       bulk-load --generate <file> <records> [text|binary] [sorted|shuffled]" << endl;
+    return 1;
+}
+
+int generate(const string& path, long long count, BulkFormat format, bool shuffled)
+{
+    vector<long long> keys(count);
+    for(long long i = 0; i < count; ++i){
+      keys[i] = i;
+    }
+    if(shuffled){
+      shuffle(keys.begin(), keys.end(), mt19937(104));
+    }
+    ofstream out(path.c_str(), ios::binary);
+    if(!out){
+      cerr << "cannot write " << path << endl;
+      return 1;
+    }
+    for(long long i = 0; i < count; ++i){
+      long long value = 3 * keys[i];
+      if(format == BULK_BINARY){
+        out.write(reinterpret_cast<const char*>(&keys[i]), sizeof(keys[i]));
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+      }
+      else{
+        out << keys[i] << ',' << value << '\n';
+      }
+    }
+    return out ? 0 : 1;
+}
+
+bool parseFormat(const char* name, BulkFormat& format)
+{
+    if(strcmp(name, "text") == 0) format = BULK_TEXT;
+    else if(strcmp(name, "binary") == 0) format = BULK_BINARY;
+    else return false;
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc < 2){
+      return usage();
+    }
+    BulkFormat format = BULK_TEXT;
+    if(strcmp(argv[1], "--generate") == 0){
+      if(argc < 4 || (argc > 4 && !parseFormat(argv[4], format))){
+        return usage();
+      }
+      bool shuffled = argc > 5 && strcmp(argv[5], "shuffled") == 0;
+      return generate(argv[2], atoll(argv[3]), format, shuffled);
+    }
+
+    if(argc > 2 && !parseFormat(argv[2], format)){
+      return usage();
+    }
+    unsigned threads = (argc > 3) ? (unsigned)atoi(argv[3]) : 0;
+    char delimiter = (argc > 4) ? (strcmp(argv[4], "\\t") == 0 ? '\t' : argv[4][0]) : ',';
+
+    AVLTree<long long, long long> tree;
+    try{
+      BulkLoadStats stats = bulkLoad(argv[1], format, tree, threads, delimiter);
+      stats.print(cout);
+    }
+    catch(const exception& error){
+      cerr << argv[1] << ": " << error.what() << endl;
+      return 1;
+    }
+    cout << "tree: " << tree.size() << " keys, " << tree.memoryUsage() / (1024 * 1024) << " MB of nodes" << endl;
+    return 0;
+}
@@ -0,0 +1,437 @@
+#ifndef BULKLOAD_H
+#define BULKLOAD_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define BULKLOAD_MMAP 1
+#endif
+
+// Bulk loading of key/value files into a tree.
+//
+// The file is memory mapped and cut into one chunk per thread (at line
+// starts for text), and the chunks are parsed in parallel. If the records
+// are not already in key order, each thread sorts its chunk and the chunks
+// are merged pairwise, also in parallel. Duplicate keys get what repeated
+// inserts would give them: the last record in the file wins, except for a
+// MultiAVLTree, which keeps every record in file order. The sorted records
+// are then handed to the tree's assignSorted, which links a balanced tree
+// in O(n) without a single comparison or rotation.
+//
+// Text files hold one "key<delimiter>value" record per line; integral,
+// floating point and std::string fields are supported. Binary files are
+// packed (key, value) records in native byte order, for trivially copyable
+// Key and Value types.
+
+enum BulkFormat { BULK_TEXT, BULK_BINARY };
+
+// A read-only view of a whole file: mmap where available, else read into
+// memory.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path) : data_(NULL), size_(0), mapped_(false)
+    {
+#ifdef BULKLOAD_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0){
+          throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+        }
+        struct stat info;
+        if(::fstat(fd, &info) != 0){
+          ::close(fd);
+          throw std::runtime_error("cannot stat " + path + ": " + std::strerror(errno));
+        }
+        size_ = (size_t)info.st_size;
+        if(size_ > 0){
+          void* address = ::mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+          if(address == MAP_FAILED){
+            ::close(fd);
+            throw std::runtime_error("cannot map " + path + ": " + std::strerror(errno));
+          }
+          ::madvise(address, size_, MADV_SEQUENTIAL);
+          data_ = static_cast<const char*>(address);
+          mapped_ = true;
+        }
+        ::close(fd); // the mapping keeps the file alive
+#else
+        std::ifstream in(path.c_str(), std::ios::binary);
+        if(!in){
+          throw std::runtime_error("cannot open " + path);
+        }
+        in.seekg(0, std::ios::end);
+        size_ = (size_t)in.tellg();
+        in.seekg(0, std::ios::beg);
+        buffer_.resize(size_);
+        if(size_ > 0 && !in.read(&buffer_[0], size_)){
+          throw std::runtime_error("cannot read " + path);
+        }
+        data_ = size_ > 0 ? &buffer_[0] : NULL;
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifdef BULKLOAD_MMAP
+        if(mapped_){
+          ::munmap(const_cast<char*>(data_), size_);
+        }
+#endif
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data_;
+    size_t size_;
+    bool mapped_;
+    std::vector<char> buffer_;  // only without mmap
+};
+
+// Where the time of one load went, and how much was read.
+struct BulkLoadStats
+{
+    BulkLoadStats() : bytes(0), records(0), duplicates(0), wasSorted(true), threads(1),
+                      mapSeconds(0), parseSeconds(0), sortSeconds(0), buildSeconds(0) {}
+
+    size_t bytes;
+    size_t records;       // parsed from the file
+    size_t duplicates;    // records dropped because a later one had the same key (0 for multi trees)
+    bool wasSorted;       // the file was already in key order
+    unsigned threads;
+    double mapSeconds;
+    double parseSeconds;
+    double sortSeconds;
+    double buildSeconds;
+
+    double totalSeconds() const { return mapSeconds + parseSeconds + sortSeconds + buildSeconds; }
+
+    double megabytesPerSecond() const
+    {
+        double seconds = totalSeconds();
+        return seconds > 0 ? bytes / (1024.0 * 1024.0) / seconds : 0;
+    }
+
+    void print(std::ostream& out) const
+    {
+        out << bytes / (1024.0 * 1024.0) << " MB, " << records << " records ("
+            << duplicates << " duplicate keys), " << threads << " threads" << std::endl;
+        out << "map " << mapSeconds * 1000 << " ms, parse " << parseSeconds * 1000 << " ms, sort "
+            << sortSeconds * 1000 << " ms" << (wasSorted ? " (already sorted)" : "")
+            << ", build " << buildSeconds * 1000 << " ms" << std::endl;
+        out << "total " << totalSeconds() * 1000 << " ms, " << megabytesPerSecond() << " MB/s" << std::endl;
+    }
+};
+
+// Text field parsers: each takes the whole field, surrounding blanks
+// allowed, and returns false unless all of it was used.
+inline void trimBulkField(const char*& begin, const char*& end)
+{
+    while(begin < end && (*begin == ' ' || *begin == '\t')) ++begin;
+    while(end > begin && (end[-1] == ' ' || end[-1] == '\t')) --end;
+}
+
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value, bool>::type
+parseBulkField(const char* begin, const char* end, T& out)
+{
+    trimBulkField(begin, end);
+    bool negative = false;
+    if(begin < end && (*begin == '-' || *begin == '+')){
+      negative = *begin == '-';
+      ++begin;
+    }
+    if(begin == end){
+      return false;
+    }
+    typename std::make_unsigned<T>::type value = 0;
+    for(; begin < end; ++begin){
+      unsigned digit = (unsigned)(*begin - '0');
+      if(digit > 9){
+        return false;
+      }
+      value = value * 10 + digit;
+    }
+    out = negative ? (T)(0 - value) : (T)value;
+    return true;
+}
+
+template<typename T>
+typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+parseBulkField(const char* begin, const char* end, T& out)
+{
+    trimBulkField(begin, end);
+    char buffer[64]; // strtod needs a terminator the mapping does not have
+    size_t length = (size_t)(end - begin);
+    if(length == 0 || length >= sizeof(buffer)){
+      return false;
+    }
+    std::memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+    char* stop;
+    out = (T)std::strtod(buffer, &stop);
+    return stop == buffer + length;
+}
+
+inline bool parseBulkField(const char* begin, const char* end, std::string& out)
+{
+    trimBulkField(begin, end);
+    out.assign(begin, end);
+    return true;
+}
+
+// Parses the text records in [begin, end), which starts at a line start
+// offset bytes into the file, appending them to out. Blank lines are
+// skipped; a malformed line throws std::runtime_error.
+template<typename Key, typename Value>
+void parseTextChunk(const char* begin, const char* end, size_t offset, char delimiter,
+                    std::vector<std::pair<Key, Value> >& out)
+{
+    const char* start = begin;
+    while(begin < end){
+      const char* lineEnd = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+      if(lineEnd == NULL){
+        lineEnd = end;
+      }
+      const char* stop = lineEnd;
+      if(stop > begin && stop[-1] == '\r'){
+        --stop;
+      }
+      if(stop > begin){
+        const char* split = static_cast<const char*>(std::memchr(begin, delimiter, stop - begin));
+        std::pair<Key, Value> item;
+        if(split == NULL || !parseBulkField(begin, split, item.first) || !parseBulkField(split + 1, stop, item.second)){
+          throw std::runtime_error("bad record at byte " + std::to_string(offset + (begin - start)));
+        }
+        out.push_back(item);
+      }
+      begin = lineEnd + 1;
+    }
+}
+
+// Copies the packed binary records [first, last) of data into out.
+template<typename Key, typename Value>
+void parseBinaryChunk(const char* data, size_t first, size_t last, std::vector<std::pair<Key, Value> >& out)
+{
+    const size_t recordSize = sizeof(Key) + sizeof(Value);
+    out.resize(last - first);
+    const char* record = data + first * recordSize;
+    for(size_t i = 0; i < out.size(); ++i, record += recordSize){
+      std::memcpy(static_cast<void*>(&out[i].first), record, sizeof(Key));
+      std::memcpy(static_cast<void*>(&out[i].second), record + sizeof(Key), sizeof(Value));
+    }
+}
+
+template<typename Key, typename Value>
+bool bulkKeyLess(const std::pair<Key, Value>& a, const std::pair<Key, Value>& b)
+{
+    return a.first < b.first;
+}
+
+// Runs work(i) for i in [0, count) on one thread each and rethrows the
+// first exception any of them threw.
+template<typename Work>
+void runBulkThreads(unsigned count, Work work)
+{
+    std::vector<std::exception_ptr> errors(count);
+    std::vector<std::thread> pool;
+    for(unsigned i = 0; i < count; ++i){
+      pool.push_back(std::thread([&work, &errors, i]() {
+        try{
+          work(i);
+        }
+        catch(...){
+          errors[i] = std::current_exception();
+        }
+      }));
+    }
+    for(unsigned i = 0; i < pool.size(); ++i){
+      pool[i].join();
+    }
+    for(unsigned i = 0; i < count; ++i){
+      if(errors[i]){
+        std::rethrow_exception(errors[i]);
+      }
+    }
+}
+
+// Parses the whole of data into records sorted by key, filling in the parse
+// and sort parts of stats. Unless keepDuplicates is set, keys are made
+// unique with the last record for a key winning; equal keys otherwise stay
+// in file order. threads == 0 uses every hardware thread.
+template<typename Key, typename Value>
+std::vector<std::pair<Key, Value> > readBulkRecords(const char* data, size_t size, BulkFormat format,
+                                                    unsigned threads, char delimiter, BulkLoadStats& stats,
+                                                    bool keepDuplicates = false)
+{
+    typedef std::pair<Key, Value> Item;
+    typedef std::chrono::steady_clock Clock;
+    if(threads == 0){
+      threads = std::thread::hardware_concurrency();
+      if(threads == 0) threads = 1;
+    }
+
+    // cut the input into one piece per thread
+    std::vector<size_t> cuts(threads + 1);
+    if(format == BULK_BINARY){
+      if(!std::is_trivially_copyable<Key>::value || !std::is_trivially_copyable<Value>::value){
+        throw std::invalid_argument("binary records need trivially copyable keys and values");
+      }
+      const size_t recordSize = sizeof(Key) + sizeof(Value);
+      if(size % recordSize != 0){
+        throw std::runtime_error("file size is not a multiple of the record size");
+      }
+      for(unsigned i = 0; i <= threads; ++i){
+        cuts[i] = (size / recordSize) * i / threads; // in records
+      }
+    }
+    else{
+      cuts[0] = 0;
+      for(unsigned i = 1; i < threads; ++i){ // move each cut to the next line start
+        size_t cut = std::max(cuts[i - 1], size * i / threads);
+        if(cut > 0 && cut < size){
+          const char* newline = static_cast<const char*>(std::memchr(data + cut - 1, '\n', size - cut + 1));
+          cut = newline == NULL ? size : (size_t)(newline - data) + 1;
+        }
+        cuts[i] = cut;
+      }
+      cuts[threads] = size;
+    }
+
+    Clock::time_point start = Clock::now();
+    std::vector<std::vector<Item> > chunks(threads);
+    std::vector<char> chunkSorted(threads, 1);
+    runBulkThreads(threads, [&](unsigned i) {
+      if(format == BULK_BINARY){
+        parseBinaryChunk(data, cuts[i], cuts[i + 1], chunks[i]);
+      }
+      else{
+        parseTextChunk(data + cuts[i], data + cuts[i + 1], cuts[i], delimiter, chunks[i]);
+      }
+      chunkSorted[i] = std::is_sorted(chunks[i].begin(), chunks[i].end(), bulkKeyLess<Key, Value>);
+    });
+
+    std::vector<size_t> offsets(1, 0); // where each non-empty chunk starts in records
+    size_t total = 0;
+    bool sorted = true;
+    const Item* previousLast = NULL;
+    for(unsigned i = 0; i < threads; ++i){
+      if(chunks[i].empty()) continue;
+      sorted = sorted && chunkSorted[i] && (previousLast == NULL || !(chunks[i].front().first < previousLast->first));
+      previousLast = &chunks[i].back();
+      total += chunks[i].size();
+      offsets.push_back(total);
+    }
+    std::vector<Item> records;
+    records.reserve(total);
+    for(unsigned i = 0; i < threads; ++i){
+      records.insert(records.end(), chunks[i].begin(), chunks[i].end());
+      std::vector<Item>().swap(chunks[i]);
+    }
+    Clock::time_point parsed = Clock::now();
+
+    if(!sorted){
+      // sort each chunk where it is, then merge neighbours until one is left;
+      // both steps are stable, so equal keys stay in file order
+      size_t pieces = offsets.size() - 1;
+      runBulkThreads((unsigned)pieces, [&](unsigned i) {
+        std::stable_sort(records.begin() + offsets[i], records.begin() + offsets[i + 1], bulkKeyLess<Key, Value>);
+      });
+      while(offsets.size() > 2){
+        size_t pairs = (offsets.size() - 1) / 2;
+        runBulkThreads((unsigned)pairs, [&](unsigned i) {
+          std::inplace_merge(records.begin() + offsets[2 * i], records.begin() + offsets[2 * i + 1],
+                             records.begin() + offsets[2 * i + 2], bulkKeyLess<Key, Value>);
+        });
+        std::vector<size_t> merged;
+        for(size_t i = 0; i < offsets.size(); i += 2){
+          merged.push_back(offsets[i]);
+        }
+        if(merged.back() != offsets.back()){ // odd piece out
+          merged.push_back(offsets.back());
+        }
+        offsets.swap(merged);
+      }
+    }
+
+    // keep the last record of each run of equal keys
+    size_t kept = 0;
+    for(size_t i = 0; i < records.size(); ++i){
+      if(!keepDuplicates && kept > 0 && !(records[kept - 1].first < records[i].first)){
+        records[kept - 1].second = records[i].second;
+      }
+      else{
+        if(kept != i) records[kept] = records[i];
+        ++kept;
+      }
+    }
+    stats.records = records.size();
+    stats.duplicates = records.size() - kept;
+    records.resize(kept);
+    Clock::time_point done = Clock::now();
+
+    stats.threads = threads;
+    stats.wasSorted = sorted;
+    stats.parseSeconds = std::chrono::duration<double>(parsed - start).count();
+    stats.sortSeconds = std::chrono::duration<double>(done - parsed).count();
+    return records;
+}
+
+template<typename Key, typename Value, typename Alloc>
+class MultiAVLTree;
+
+// Whether bulkLoad keeps every record of a duplicated key for Tree, i.e.
+// whether repeated inserts into it would.
+template<typename Tree>
+struct BulkKeepsDuplicates : std::false_type {};
+
+template<typename Key, typename Value, typename Alloc>
+struct BulkKeepsDuplicates<MultiAVLTree<Key, Value, Alloc> > : std::true_type {};
+
+// Loads a file into tree, replacing its contents. Tree needs assignSorted,
+// as AVLTree and the trees derived from it have.
+template<typename Tree>
+BulkLoadStats bulkLoad(const std::string& path, BulkFormat format, Tree& tree, unsigned threads = 0, char delimiter = ',')
+{
+    typedef typename Tree::iterator::value_type Item;
+    typedef typename std::remove_const<typename Item::first_type>::type Key;
+    typedef typename Item::second_type Value;
+    typedef std::chrono::steady_clock Clock;
+
+    BulkLoadStats stats;
+    Clock::time_point start = Clock::now();
+    MappedFile file(path);
+    stats.bytes = file.size();
+    stats.mapSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<std::pair<Key, Value> > records =
+        readBulkRecords<Key, Value>(file.data(), file.size(), format, threads, delimiter, stats,
+                                    BulkKeepsDuplicates<Tree>::value);
+
+    Clock::time_point build = Clock::now();
+    tree.assignSorted(records.begin(), records.end());
+    stats.buildSeconds = std::chrono::duration<double>(Clock::now() - build).count();
+    return stats;
+}
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef EQUAL_PATHS_ITER_H
+#define EQUAL_PATHS_ITER_H
+
+#include "equal-paths.h"
+
+/**
+ * @brief Same answer as equalPaths(), but walks the tree with an explicit
+ *        stack instead of recursion, so trees millions of levels deep do not
+ *        overflow the call stack. Returns as soon as a leaf depth differs
+ *        from the first one seen.
+ *
+ * @param root Pointer to the root of the tree to check for equal paths
+ */
+bool equalPathsIterative(Node * root);
+
+#endif
@@ -1,6 +1,9 @@
 #include <iostream>
 #include <cstdlib>
 #include "equal-paths.h"
+#include "equal-paths-iter.h"
+#include "leaf-depths.h"
+#include <sstream>
 using namespace std;
 
 
@@ -18,6 +21,20 @@ void setNode(Node* n, int key, Node* left=NULL, Node* right=NULL)
   n->right = right;
 }
 
+// Serializes the tree at a and runs the streaming analyzer on the bytes
+void printStreamed(const char* msg)
+{
+  stringstream ss;
+  writePreorder(a, ss);
+  LeafDepthStats stats;
+  if(!analyzeLeafDepths(ss, stats)) {
+    cout << msg << " streamed: bad encoding" << endl;
+    return;
+  }
+  cout << msg << " streamed: " << stats.equal << " (leaf depths "
+       << stats.minDepth << ".." << stats.maxDepth << ")" << endl;
+}
+
 void test1(const char* msg)
 {
   setNode(a,1,NULL, NULL);
@@ -37,6 +54,7 @@ void test3(const char* msg)
   setNode(b,2,NULL,NULL);
   setNode(c,3,NULL,NULL);
   cout << msg << ": " <<   equalPaths(a) << endl;
+  printStreamed(msg);
 }
 
 void test4(const char* msg)
@@ -53,6 +71,53 @@ void test5(const char* msg)
   setNode(c,3,NULL,NULL);
   setNode(d,4,NULL,NULL);
   cout << msg << ": " <<   equalPaths(a) << endl;
+  printStreamed(msg);
+}
+
+// The iterative version must agree with equalPaths on every small shape above
+void testIterative(const char* msg)
+{
+  int agree = 0;
+  setNode(a,1,NULL,NULL);
+  agree += (equalPaths(a) == equalPathsIterative(a));
+  setNode(a,1,b,NULL);
+  setNode(b,2,NULL,NULL);
+  agree += (equalPaths(a) == equalPathsIterative(a));
+  setNode(a,1,b,c);
+  setNode(c,3,NULL,NULL);
+  agree += (equalPaths(a) == equalPathsIterative(a));
+  setNode(a,1,NULL,c);
+  agree += (equalPaths(a) == equalPathsIterative(a));
+  setNode(a,1,b,c);
+  setNode(b,2,NULL,d);
+  setNode(d,4,NULL,NULL);
+  agree += (equalPaths(a) == equalPathsIterative(a));
+  cout << msg << ": " << agree << " of 5 agree" << endl;
+}
+
+// A chain of a million nodes is far too deep for the recursive version
+void testDeep(const char* msg)
+{
+  const int depth = 1000000;
+  Node* root = new Node(0);
+  Node* curr = root;
+  for(int i = 1; i < depth; i++) {
+    curr->left = new Node(i);
+    curr = curr->left;
+  }
+  cout << msg << ": " <<   equalPathsIterative(root) << endl;
+  stringstream ss;
+  writePreorder(root, ss);
+  LeafDepthStats stats;
+  if(analyzeLeafDepths(ss, stats)) {
+    cout << msg << " streamed: " << stats.equal << " (" << stats.nodes << " nodes)" << endl;
+  }
+  curr = root;
+  while(curr != NULL) {
+    Node* next = curr->left;
+    delete curr;
+    curr = next;
+  }
 }
 
 int main()
@@ -67,6 +132,8 @@ int main()
   test3("Test3");
   test4("Test4");
   test5("Test5");
+  testIterative("TestIterative");
+  testDeep("TestDeep");
  
   delete a;
   delete b;
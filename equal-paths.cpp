@@ -1,9 +1,12 @@
 #ifndef RECCHECK
 //if you want to add any #includes like <iostream> you must do them here (before the next endif)
+#include <vector>
+#include <utility>
 
 #endif
 
 #include "equal-paths.h"
+#include "equal-paths-iter.h"
 using namespace std;
 
 // You may add any prototypes of helper functions here
@@ -47,3 +50,38 @@ bool equalPaths(Node * root)
 
 }
 
+bool equalPathsIterative(Node * root)
+{
+    if(root == nullptr){ // an empty tree trivially has equal paths
+      return true;
+    }
+
+    int leaf = -1; // no leaf yet
+    vector<pair<Node*, int> > pending; // nodes still to visit with their depth
+    pending.push_back(make_pair(root, 0));
+
+    while(!pending.empty()){
+      Node* node = pending.back().first;
+      int depth = pending.back().second;
+      pending.pop_back();
+
+      if(node->left == nullptr && node->right == nullptr){ // if its a leaf node
+        if(leaf == -1){ // remember the depth if it's the first leaf
+          leaf = depth;
+        }
+        else if(depth != leaf){ // first mismatch decides the answer
+          return false;
+        }
+        continue;
+      }
+
+      // push right first so the left subtree is finished before the right one starts
+      if(node->right != nullptr){
+        pending.push_back(make_pair(node->right, depth + 1));
+      }
+      if(node->left != nullptr){
+        pending.push_back(make_pair(node->left, depth + 1));
+      }
+    }
+    return true;
+}
@@ -0,0 +1,275 @@
+#ifndef INTERVALBST_H
+#define INTERVALBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include <stdexcept>
+#include "bst.h"
+#include "avlbst.h"
+
+/**
+* An AVLNode keyed by a closed interval [lo, hi] that also caches the
+* largest hi anywhere in its subtree.
+*/
+template <typename T, typename Value>
+class IntervalNode : public AVLNode<std::pair<T, T>, Value>
+{
+public:
+    IntervalNode(const std::pair<T, T>& key, const Value& value, AVLNode<std::pair<T, T>, Value>* parent);
+    virtual ~IntervalNode();
+
+    const T& getMaxEnd() const;
+    void setMaxEnd(const T& maxEnd);
+
+protected:
+    T maxEnd_;
+};
+
+/*
+  -------------------------------------------------
+  Begin implementations for the IntervalNode class.
+  -------------------------------------------------
+*/
+
+template<typename T, typename Value>
+IntervalNode<T, Value>::IntervalNode(const std::pair<T, T>& key, const Value& value, AVLNode<std::pair<T, T>, Value>* parent) :
+    AVLNode<std::pair<T, T>, Value>(key, value, parent), maxEnd_(key.second)
+{
+
+}
+
+template<typename T, typename Value>
+IntervalNode<T, Value>::~IntervalNode()
+{
+
+}
+
+/**
+* The largest upper endpoint in this node's subtree.
+*/
+template<typename T, typename Value>
+const T& IntervalNode<T, Value>::getMaxEnd() const
+{
+    return maxEnd_;
+}
+
+template<typename T, typename Value>
+void IntervalNode<T, Value>::setMaxEnd(const T& maxEnd)
+{
+    maxEnd_ = maxEnd;
+}
+
+/*
+  -----------------------------------------------
+  End implementations for the IntervalNode class.
+  -----------------------------------------------
+*/
+
+/**
+* An AVLTree of closed intervals [lo, hi], ordered by (lo, hi). Every node
+* caches the largest hi in its subtree, which rotations, rebuilds, the
+* predecessor swap in remove and the final retrace all keep up to date.
+* That lets overlap queries skip any subtree that ends before the query
+* starts: a query with k results visits O(min(n, (k + 1) log n)) nodes, and
+* close to O(log n + k) when results are clustered in key order.
+*/
+template <typename T, typename Value,
+          typename Alloc = std::allocator<std::pair<const std::pair<T, T>, Value> > >
+class IntervalTree : public AVLTree<std::pair<T, T>, Value, Alloc>
+{
+public:
+    typedef std::pair<T, T> Interval;
+    typedef typename BinarySearchTree<Interval, Value, Alloc>::iterator iterator;
+
+    IntervalTree();
+    explicit IntervalTree(const Alloc& alloc);
+    IntervalTree(const IntervalTree& other);
+    IntervalTree(IntervalTree&& other);
+    IntervalTree& operator=(const IntervalTree& other);
+    IntervalTree& operator=(IntervalTree&& other);
+    void swap(IntervalTree& other);
+    virtual ~IntervalTree();
+    virtual void insert(const std::pair<const Interval, Value>& new_item);
+
+    std::vector<iterator> overlaps(const T& lo, const T& hi) const;
+    std::vector<iterator> stab(const T& point) const;
+
+protected:
+    typedef IntervalNode<T, Value> NodeType;
+
+    virtual AVLNode<Interval, Value>* createNode(const Interval& key, const Value& value, AVLNode<Interval, Value>* parent);
+    virtual void destroyNode(Node<Interval, Value>* node);
+    virtual void augmentNode(Node<Interval, Value>* node);
+    virtual void augmentPath(Node<Interval, Value>* node);
+    void collectOverlaps(NodeType* node, const T& lo, const T& hi, std::vector<iterator>& out) const;
+};
+
+template<typename T, typename Value, typename Alloc>
+IntervalTree<T, Value, Alloc>::IntervalTree() : AVLTree<Interval, Value, Alloc>()
+{
+
+}
+
+template<typename T, typename Value, typename Alloc>
+IntervalTree<T, Value, Alloc>::IntervalTree(const Alloc& alloc) : AVLTree<Interval, Value, Alloc>(alloc)
+{
+
+}
+
+/**
+* Deep copy in O(n); nodes are cloned as IntervalNodes, max endpoints included.
+*/
+template<typename T, typename Value, typename Alloc>
+IntervalTree<T, Value, Alloc>::IntervalTree(const IntervalTree<T, Value, Alloc>& other) :
+    AVLTree<Interval, Value, Alloc>(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.get_allocator()))
+{
+    this->template copyFrom<NodeType>(other);
+    this->tombstoneMode_ = other.tombstoneMode_;
+    this->compactThreshold_ = other.compactThreshold_;
+    this->relaxedBound_ = other.relaxedBound_;
+    this->dead_ = other.dead_;
+}
+
+/**
+* Move constructor; O(1), leaves other empty.
+*/
+template<typename T, typename Value, typename Alloc>
+IntervalTree<T, Value, Alloc>::IntervalTree(IntervalTree<T, Value, Alloc>&& other) :
+    AVLTree<Interval, Value, Alloc>(std::move(other))
+{
+
+}
+
+template<typename T, typename Value, typename Alloc>
+IntervalTree<T, Value, Alloc>& IntervalTree<T, Value, Alloc>::operator=(const IntervalTree<T, Value, Alloc>& other)
+{
+    if(this != &other){
+      IntervalTree<T, Value, Alloc> copy(other);
+      this->swapTree(copy);
+    }
+    return *this;
+}
+
+template<typename T, typename Value, typename Alloc>
+IntervalTree<T, Value, Alloc>& IntervalTree<T, Value, Alloc>::operator=(IntervalTree<T, Value, Alloc>&& other)
+{
+    this->swapTree(other);
+    return *this;
+}
+
+template<typename T, typename Value, typename Alloc>
+void IntervalTree<T, Value, Alloc>::swap(IntervalTree<T, Value, Alloc>& other)
+{
+    this->swapTree(other);
+}
+
+/**
+* Frees the nodes here so they are freed as IntervalNodes.
+*/
+template<typename T, typename Value, typename Alloc>
+IntervalTree<T, Value, Alloc>::~IntervalTree()
+{
+    this->clear();
+}
+
+/**
+* Inserts [lo, hi] = new_item.first; an interval with hi < lo is rejected.
+* Inserting the same interval again overwrites its value.
+*/
+template<typename T, typename Value, typename Alloc>
+void IntervalTree<T, Value, Alloc>::insert(const std::pair<const Interval, Value>& new_item)
+{
+    if(new_item.first.second < new_item.first.first){
+      throw std::invalid_argument("interval end is before its start");
+    }
+    AVLTree<Interval, Value, Alloc>::insert(new_item);
+}
+
+/**
+* Returns iterators to every interval that shares at least one point with
+* [lo, hi], in key order.
+*/
+template<typename T, typename Value, typename Alloc>
+std::vector<typename IntervalTree<T, Value, Alloc>::iterator>
+IntervalTree<T, Value, Alloc>::overlaps(const T& lo, const T& hi) const
+{
+    std::vector<iterator> out;
+    collectOverlaps(static_cast<NodeType*>(this->root_), lo, hi, out);
+    return out;
+}
+
+/**
+* Returns iterators to every interval containing point, in key order.
+*/
+template<typename T, typename Value, typename Alloc>
+std::vector<typename IntervalTree<T, Value, Alloc>::iterator>
+IntervalTree<T, Value, Alloc>::stab(const T& point) const
+{
+    return overlaps(point, point);
+}
+
+/**
+* In-order walk that skips subtrees whose max endpoint is before lo, and
+* stops going right once intervals start after hi. A subtree is only
+* entered if it holds a result or borders one of the search paths.
+*/
+template<typename T, typename Value, typename Alloc>
+void IntervalTree<T, Value, Alloc>::collectOverlaps(NodeType* node, const T& lo, const T& hi, std::vector<iterator>& out) const
+{
+    if(node == nullptr || node->getMaxEnd() < lo){ // nothing here reaches lo
+      return;
+    }
+    collectOverlaps(static_cast<NodeType*>(node->getLeft()), lo, hi, out);
+    if(hi < node->getKey().first){ // this node and its right subtree start after hi
+      return;
+    }
+    if(!(node->getKey().second < lo) && this->firstVisible(node) == node){ // skip tombstones
+      out.push_back(this->makeIterator(node));
+    }
+    collectOverlaps(static_cast<NodeType*>(node->getRight()), lo, hi, out);
+}
+
+template<typename T, typename Value, typename Alloc>
+AVLNode<std::pair<T, T>, Value>* IntervalTree<T, Value, Alloc>::createNode(const Interval& key, const Value& value, AVLNode<Interval, Value>* parent)
+{
+    return this->template allocateNode<NodeType>(key, value, parent);
+}
+
+template<typename T, typename Value, typename Alloc>
+void IntervalTree<T, Value, Alloc>::destroyNode(Node<Interval, Value>* node)
+{
+    this->deallocateNode(static_cast<NodeType*>(node));
+}
+
+/**
+* maxEnd = the largest of the node's own end and its children's max ends.
+*/
+template<typename T, typename Value, typename Alloc>
+void IntervalTree<T, Value, Alloc>::augmentNode(Node<Interval, Value>* node)
+{
+    NodeType* current = static_cast<NodeType*>(node);
+    T maxEnd = current->getKey().second;
+    NodeType* left = static_cast<NodeType*>(current->getLeft());
+    NodeType* right = static_cast<NodeType*>(current->getRight());
+    if(left != nullptr && maxEnd < left->getMaxEnd()){
+      maxEnd = left->getMaxEnd();
+    }
+    if(right != nullptr && maxEnd < right->getMaxEnd()){
+      maxEnd = right->getMaxEnd();
+    }
+    current->setMaxEnd(maxEnd);
+}
+
+template<typename T, typename Value, typename Alloc>
+void IntervalTree<T, Value, Alloc>::augmentPath(Node<Interval, Value>* node)
+{
+    while(node != nullptr){
+      augmentNode(node);
+      node = node->getParent();
+    }
+}
+
+#endif
@@ -0,0 +1,137 @@
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <random>
+#include <chrono>
+#include "bst.h"
+#include "avlbst.h"
+#include "rbbst.h"
+#include "threadedbst.h"
+#include "parentlessavl.h"
+#include "latency.h"
+
+using namespace std;
+
+// Runs a mixed insert/remove/find workload against one tree for a fixed
+// time and reports per-operation latency percentiles, both for every
+// reporting interval and for the whole run. One timed full scan is done at
+// the end of each interval.
+//
+// usage: latency-driver [tree] [seconds] [num_keys] [insert_pct] [remove_pct] [interval_seconds]
+//   tree is one of avl, rb, threaded, parentless, bst (scapegoat, alpha 0.7)
+//   the operations that are neither inserts nor removes are finds
+
+struct Options {
+    string tree;
+    double seconds;
+    int numKeys;
+    int insertPct;
+    int removePct;
+    double interval;
+};
+
+template<typename Tree>
+void prepare(Tree&)
+{
+
+}
+
+void prepare(BinarySearchTree<int, int>& tree)
+{
+    tree.setScapegoatAlpha(0.7);
+}
+
+template<typename Tree>
+void run(const Options& options)
+{
+    typedef chrono::steady_clock Clock;
+    TimedTree<Tree> timed;
+    prepare(timed.tree());
+
+    // start from a tree holding about half the key space, untimed
+    mt19937 rng(104);
+    uniform_int_distribution<int> keyDist(0, 2 * options.numKeys - 1);
+    for(int i = 0; i < options.numKeys; ++i){
+      int key = keyDist(rng);
+      timed.tree().insert(make_pair(key, key));
+    }
+
+    LatencyHistogram totals[TimedTree<Tree>::OP_COUNT];
+    const char* names[TimedTree<Tree>::OP_COUNT] = { "insert", "remove", "find  ", "scan  " };
+    long long checksum = 0;
+    Clock::time_point start = Clock::now();
+    Clock::time_point stop = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(options.seconds));
+    Clock::time_point nextReport = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(options.interval));
+    int intervalIndex = 0;
+
+    while(true){
+      for(int i = 0; i < 1024; ++i){ // check the clock once per 1024 operations
+        int roll = rng() % 100;
+        int key = keyDist(rng);
+        if(roll < options.insertPct){
+          timed.insert(make_pair(key, key));
+        }
+        else if(roll < options.insertPct + options.removePct){
+          timed.remove(key);
+        }
+        else if(timed.find(key) != timed.tree().end()){
+          checksum += key;
+        }
+      }
+
+      Clock::time_point now = Clock::now();
+      if(now >= nextReport || now >= stop){
+        timed.scan([&checksum](const pair<const int, int>& item) { checksum += item.second; });
+        cout << "interval " << ++intervalIndex << " (" << timed.tree().size() << " keys):" << endl;
+        timed.report(cout);
+        for(int op = 0; op < TimedTree<Tree>::OP_COUNT; ++op){
+          totals[op].merge(timed.latency((typename TimedTree<Tree>::Op)op));
+        }
+        timed.resetLatency();
+        nextReport = now + chrono::duration_cast<Clock::duration>(chrono::duration<double>(options.interval));
+      }
+      if(now >= stop){
+        break;
+      }
+    }
+
+    cout << "\ntotal over " << options.seconds << " s:" << endl;
+    for(int op = 0; op < TimedTree<Tree>::OP_COUNT; ++op){
+      if(totals[op].count() > 0){
+        totals[op].print(cout, names[op]);
+      }
+    }
+    cout << "checksum " << checksum << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    options.tree = (argc > 1) ? argv[1] : "avl";
+    options.seconds = (argc > 2) ? atof(argv[2]) : 60;
+    options.numKeys = (argc > 3) ? atoi(argv[3]) : 1000000;
+    options.insertPct = (argc > 4) ? atoi(argv[4]) : 25;
+    options.removePct = (argc > 5) ? atoi(argv[5]) : 25;
+    options.interval = (argc > 6) ? atof(argv[6]) : 10;
+
+    if(options.seconds <= 0 || options.interval <= 0 || options.numKeys <= 0 ||
+       options.insertPct < 0 || options.removePct < 0 || options.insertPct + options.removePct > 100){
+      cerr << "usage: latency-driver [avl|rb|threaded|parentless|bst] [seconds] [num_keys] "
+           << "[insert_pct] [remove_pct] [interval_seconds]" << endl;
+      return 1;
+    }
+
+    cout << options.tree << ": " << options.numKeys << " keys, " << options.insertPct << "% insert, "
+         << options.removePct << "% remove, " << 100 - options.insertPct - options.removePct
+         << "% find, " << options.seconds << " s" << endl;
+    if(options.tree == "avl") run<AVLTree<int, int> >(options);
+    else if(options.tree == "rb") run<RBTree<int, int> >(options);
+    else if(options.tree == "threaded") run<ThreadedAVLTree<int, int> >(options);
+    else if(options.tree == "parentless") run<ParentlessAVLTree<int, int> >(options);
+    else if(options.tree == "bst") run<BinarySearchTree<int, int> >(options);
+    else{
+      cerr << "unknown tree: " << options.tree << endl;
+      return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,222 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <utility>
+#include <type_traits>
+
+// Latency histograms for tree operations.
+//
+// LatencyHistogram is a log-linear (HDR style) histogram of nanosecond
+// values: exact below 64 ns, then every power of two is split into 32
+// buckets, so any recorded value is known to within about 3%. Recording is
+// a few shifts and an increment, and the whole histogram is a fixed 15 KB.
+//
+// TimedTree wraps any of the trees and records the latency of every
+// insert, remove, find and iterator step into one histogram per operation.
+// Each timed call costs two steady_clock reads on top of the operation.
+
+class LatencyHistogram
+{
+public:
+    static const int SUB_BITS = 5;                      // 32 buckets per power of two
+    static const int SUB_COUNT = 1 << SUB_BITS;
+    static const int BUCKETS = (65 - SUB_BITS) * SUB_COUNT;     // enough for any uint64_t
+
+    LatencyHistogram() { reset(); }
+
+    void reset()
+    {
+        std::memset(counts_, 0, sizeof(counts_));
+        total_ = 0;
+        sum_ = 0;
+        max_ = 0;
+        min_ = UINT64_MAX;
+    }
+
+    void record(uint64_t ns)
+    {
+        ++counts_[bucketOf(ns)];
+        ++total_;
+        sum_ += ns;
+        if(ns > max_) max_ = ns;
+        if(ns < min_) min_ = ns;
+    }
+
+    void merge(const LatencyHistogram& other)
+    {
+        for(int i = 0; i < BUCKETS; ++i){
+          counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        sum_ += other.sum_;
+        if(other.max_ > max_) max_ = other.max_;
+        if(other.min_ < min_) min_ = other.min_;
+    }
+
+    uint64_t count() const { return total_; }
+    uint64_t max() const { return max_; }
+    uint64_t min() const { return total_ == 0 ? 0 : min_; }
+    double mean() const { return total_ == 0 ? 0 : (double)sum_ / total_; }
+
+    // Smallest recorded-bucket upper bound that at least p (0..1) of the
+    // values are <= to, capped at the true maximum.
+    uint64_t percentile(double p) const
+    {
+        if(total_ == 0){
+          return 0;
+        }
+        uint64_t rank = (uint64_t)(p * total_ + 0.5);
+        if(rank < 1) rank = 1;
+        if(rank > total_) rank = total_;
+        uint64_t seen = 0;
+        for(int i = 0; i < BUCKETS; ++i){
+          seen += counts_[i];
+          if(seen >= rank){
+            uint64_t high = bucketHigh(i);
+            return high < max_ ? high : max_;
+          }
+        }
+        return max_;
+    }
+
+    // One line: count, mean, p50, p99, p99.9 and max, in nanoseconds.
+    void print(std::ostream& out, const char* name) const
+    {
+        out << name << "  n=" << total_ << "  mean=" << (uint64_t)mean()
+            << "  p50=" << percentile(0.5) << "  p99=" << percentile(0.99)
+            << "  p99.9=" << percentile(0.999) << "  max=" << max_ << " ns" << std::endl;
+    }
+
+protected:
+    static int highestBit(uint64_t value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(value);
+#else
+        int bit = 0;
+        while(value >>= 1) ++bit;
+        return bit;
+#endif
+    }
+
+    // Values below 2 * SUB_COUNT get a bucket each; above that, value >> shift
+    // lands in [SUB_COUNT, 2 * SUB_COUNT) and picks the bucket.
+    static int bucketOf(uint64_t value)
+    {
+        if(value < (uint64_t)(2 * SUB_COUNT)){
+          return (int)value;
+        }
+        int shift = highestBit(value) - SUB_BITS;
+        return shift * SUB_COUNT + (int)(value >> shift);
+    }
+
+    static uint64_t bucketHigh(int bucket)
+    {
+        if(bucket < 2 * SUB_COUNT){
+          return (uint64_t)bucket;
+        }
+        int shift = bucket / SUB_COUNT - 1;
+        uint64_t sub = (uint64_t)(bucket - shift * SUB_COUNT);
+        return ((sub + 1) << shift) - 1;
+    }
+
+    uint64_t counts_[BUCKETS];
+    uint64_t total_;
+    uint64_t sum_;
+    uint64_t max_;
+    uint64_t min_;
+};
+
+// Wraps a tree (BinarySearchTree and friends, or ParentlessAVLTree) and
+// times every operation that goes through the wrapper. The tree itself
+// stays reachable through tree() for untimed access.
+template<typename Tree>
+class TimedTree
+{
+public:
+    typedef typename Tree::iterator iterator;
+    typedef typename iterator::value_type Item;
+    typedef typename std::remove_const<typename Item::first_type>::type Key;
+
+    enum Op { INSERT, REMOVE, FIND, SCAN, OP_COUNT };
+
+    void insert(const Item& item)
+    {
+        Clock::time_point start = Clock::now();
+        tree_.insert(item);
+        record(INSERT, start);
+    }
+
+    void remove(const Key& key)
+    {
+        Clock::time_point start = Clock::now();
+        tree_.remove(key);
+        record(REMOVE, start);
+    }
+
+    iterator find(const Key& key)
+    {
+        Clock::time_point start = Clock::now();
+        iterator it = tree_.find(key);
+        record(FIND, start);
+        return it;
+    }
+
+    // Visits every item in order, timing begin() and each increment as one
+    // iterator step; visit's own time is not counted.
+    template<typename Visit>
+    void scan(Visit visit)
+    {
+        Clock::time_point start = Clock::now();
+        iterator it = tree_.begin();
+        iterator end = tree_.end();
+        record(SCAN, start);
+        while(it != end){
+          visit(*it);
+          start = Clock::now();
+          ++it;
+          record(SCAN, start);
+        }
+    }
+
+    Tree& tree() { return tree_; }
+    const Tree& tree() const { return tree_; }
+    const LatencyHistogram& latency(Op op) const { return histograms_[op]; }
+
+    void resetLatency()
+    {
+        for(int i = 0; i < OP_COUNT; ++i){
+          histograms_[i].reset();
+        }
+    }
+
+    // Prints one line per operation that was timed at least once.
+    void report(std::ostream& out) const
+    {
+        const char* names[OP_COUNT] = { "insert", "remove", "find  ", "scan  " };
+        for(int i = 0; i < OP_COUNT; ++i){
+          if(histograms_[i].count() > 0){
+            histograms_[i].print(out, names[i]);
+          }
+        }
+    }
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    void record(Op op, Clock::time_point start)
+    {
+        Clock::time_point stop = Clock::now();
+        histograms_[op].record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+    }
+
+    Tree tree_;
+    LatencyHistogram histograms_[OP_COUNT];
+};
+
+#endif
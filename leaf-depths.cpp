@@ -0,0 +1,122 @@
+#include <vector>
+#include <cstdint>
+#include "leaf-depths.h"
+using namespace std;
+
+// Small read buffer on top of the stream so we are not paying per byte.
+class ByteReader {
+public:
+    ByteReader(istream& in) : in_(in), pos_(0), len_(0), buf_(1 << 16) {}
+
+    bool get(unsigned char& byte)
+    {
+      if(pos_ == len_){
+        in_.read(&buf_[0], buf_.size());
+        len_ = in_.gcount();
+        pos_ = 0;
+        if(len_ == 0){
+          return false;
+        }
+      }
+      byte = (unsigned char)buf_[pos_++];
+      return true;
+    }
+
+private:
+    istream& in_;
+    size_t pos_, len_;
+    vector<char> buf_;
+};
+
+void writePreorder(Node * root, ostream& out)
+{
+    vector<Node*> pending; // nodes still to write
+    if(root != nullptr){
+      pending.push_back(root);
+    }
+
+    while(!pending.empty()){
+      Node* node = pending.back();
+      pending.pop_back();
+
+      char record[5];
+      record[0] = (node->left != nullptr ? LEAF_DEPTHS_HAS_LEFT : 0) |
+                  (node->right != nullptr ? LEAF_DEPTHS_HAS_RIGHT : 0);
+      uint32_t key = (uint32_t)node->key;
+      for(int i = 0; i < 4; i++){ // little endian regardless of the host
+        record[1 + i] = (char)((key >> (8 * i)) & 0xff);
+      }
+      out.write(record, sizeof(record));
+
+      if(node->right != nullptr){ // right goes under left so left comes out first
+        pending.push_back(node->right);
+      }
+      if(node->left != nullptr){
+        pending.push_back(node->left);
+      }
+    }
+}
+
+bool analyzeLeafDepths(istream& in, LeafDepthStats& stats)
+{
+    stats.equal = true;
+    stats.minDepth = -1;
+    stats.maxDepth = -1;
+    stats.nodes = 0;
+    stats.leaves = 0;
+
+    ByteReader reader(in);
+    // unfinished children for every node on the current path; its size is the
+    // depth of the next node in the stream
+    vector<unsigned char> open;
+
+    unsigned char flags;
+    if(!reader.get(flags)){ // empty stream is the empty tree
+      return true;
+    }
+
+    while(true){
+      unsigned char keyByte;
+      for(int i = 0; i < 4; i++){ // keys do not matter for depths
+        if(!reader.get(keyByte)){
+          return false;
+        }
+      }
+      if(flags & ~(LEAF_DEPTHS_HAS_LEFT | LEAF_DEPTHS_HAS_RIGHT)){
+        return false;
+      }
+      stats.nodes++;
+
+      int children = ((flags & LEAF_DEPTHS_HAS_LEFT) ? 1 : 0) + ((flags & LEAF_DEPTHS_HAS_RIGHT) ? 1 : 0);
+      if(children > 0){
+        open.push_back((unsigned char)children);
+      }
+      else{ // a leaf at depth open.size()
+        int depth = (int)open.size();
+        if(stats.leaves == 0){
+          stats.minDepth = depth;
+          stats.maxDepth = depth;
+        }
+        else{
+          if(depth < stats.minDepth) stats.minDepth = depth;
+          if(depth > stats.maxDepth) stats.maxDepth = depth;
+        }
+        stats.leaves++;
+
+        // finishing this leaf may finish its ancestors too
+        while(!open.empty() && --open.back() == 0){
+          open.pop_back();
+        }
+        if(open.empty()){ // the whole tree has been read
+          break;
+        }
+      }
+
+      if(!reader.get(flags)){ // stream ended with children still missing
+        return false;
+      }
+    }
+
+    stats.equal = (stats.minDepth == stats.maxDepth);
+    return true;
+}
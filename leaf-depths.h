@@ -0,0 +1,42 @@
+#ifndef LEAF_DEPTHS_H
+#define LEAF_DEPTHS_H
+
+#include <cstdlib>
+#include <iostream>
+#include "equal-paths.h"
+
+/*
+ * Compact preorder encoding of the equal-paths.h Node shape:
+ *
+ *   per node, in preorder:  1 flag byte   (bit 0: has left, bit 1: has right)
+ *                           4 key bytes   (int32, little endian)
+ *
+ * An empty tree is an empty stream.
+ */
+const unsigned char LEAF_DEPTHS_HAS_LEFT = 0x1;
+const unsigned char LEAF_DEPTHS_HAS_RIGHT = 0x2;
+
+struct LeafDepthStats {
+    bool equal;         // true if every leaf has the same depth
+    int minDepth;       // depth of the shallowest leaf (root is 0), -1 if empty
+    int maxDepth;       // depth of the deepest leaf, -1 if empty
+    size_t nodes;
+    size_t leaves;
+};
+
+/**
+ * @brief Writes the tree rooted at root to out in the encoding above.
+ *        Iterative, so any depth is fine.
+ */
+void writePreorder(Node * root, std::ostream& out);
+
+/**
+ * @brief Reads one encoded tree from in and computes its leaf depth stats in
+ *        a single pass, keeping only one small counter per level of the
+ *        current path (memory proportional to depth, no Nodes built).
+ *
+ * @return false if the stream ends in the middle of the tree or has bad flags
+ */
+bool analyzeLeafDepths(std::istream& in, LeafDepthStats& stats);
+
+#endif
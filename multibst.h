@@ -0,0 +1,647 @@
+#ifndef MULTIBST_H
+#define MULTIBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+#include <stdexcept>
+#include "bst.h"
+#include "avlbst.h"
+
+/**
+* The values a node holds beyond its first one, in insertion order. When
+* Value is an empty type (the multiset case) there is nothing to keep, so
+* the specialization below stores nothing and the node is just a count.
+*/
+template <typename Value, bool Empty = std::is_empty<Value>::value>
+class MultiValues
+{
+public:
+    void push(const Value& value) { values_.push_back(value); }
+    void pop() { values_.pop_back(); }
+    void erase(size_t index) { values_.erase(values_.begin() + index); }
+    void clear() { std::vector<Value>().swap(values_); }
+    Value& at(size_t index) { return values_[index]; }
+    size_t bytes() const { return values_.capacity() * sizeof(Value); }
+
+private:
+    std::vector<Value> values_;
+};
+
+template <typename Value>
+class MultiValues<Value, true>
+{
+public:
+    void push(const Value&) {}
+    void pop() {}
+    void erase(size_t) {}
+    void clear() {}
+    Value& at(size_t) { static Value value; return value; }
+    size_t bytes() const { return 0; }
+};
+
+/**
+* An AVLNode for one key and all the elements stored under it: the first
+* value lives in the item as usual, later ones in a MultiValues list.
+*/
+template <typename Key, typename Value>
+class MultiAVLNode : public AVLNode<Key, Value>, private MultiValues<Value>
+{
+public:
+    MultiAVLNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent);
+    virtual ~MultiAVLNode();
+
+    size_t getCount() const;
+    Value& valueAt(size_t index);
+    void addValue(const Value& value);
+    void eraseValue(size_t index);
+    void resetValues();
+    size_t extraBytes() const;
+
+protected:
+    typedef MultiValues<Value> Extra; // a base, so the set case adds no bytes
+
+    size_t count_;
+};
+
+/*
+  ------------------------------------------------
+  Begin implementations for the MultiAVLNode class.
+  ------------------------------------------------
+*/
+
+template<typename Key, typename Value>
+MultiAVLNode<Key, Value>::MultiAVLNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent) :
+    AVLNode<Key, Value>(key, value, parent), count_(1)
+{
+
+}
+
+template<typename Key, typename Value>
+MultiAVLNode<Key, Value>::~MultiAVLNode()
+{
+
+}
+
+/**
+* Number of elements with this node's key.
+*/
+template<typename Key, typename Value>
+size_t MultiAVLNode<Key, Value>::getCount() const
+{
+    return count_;
+}
+
+/**
+* The index-th element's value, 0 <= index < getCount().
+*/
+template<typename Key, typename Value>
+Value& MultiAVLNode<Key, Value>::valueAt(size_t index)
+{
+    return index == 0 ? this->getValue() : Extra::at(index - 1);
+}
+
+template<typename Key, typename Value>
+void MultiAVLNode<Key, Value>::addValue(const Value& value)
+{
+    Extra::push(value);
+    ++count_;
+}
+
+/**
+* Removes the index-th element; the ones after it move up. Must not be
+* called on the last remaining element.
+*/
+template<typename Key, typename Value>
+void MultiAVLNode<Key, Value>::eraseValue(size_t index)
+{
+    if(index + 1 == count_){ // the common case: drop the newest
+      Extra::pop();
+    }
+    else if(index == 0){
+      this->setValue(Extra::at(0));
+      Extra::erase(0);
+    }
+    else{
+      Extra::erase(index - 1);
+    }
+    --count_;
+}
+
+/**
+* Back to a single element, freeing the list.
+*/
+template<typename Key, typename Value>
+void MultiAVLNode<Key, Value>::resetValues()
+{
+    Extra::clear();
+    count_ = 1;
+}
+
+template<typename Key, typename Value>
+size_t MultiAVLNode<Key, Value>::extraBytes() const
+{
+    return Extra::bytes();
+}
+
+/*
+  ----------------------------------------------
+  End implementations for the MultiAVLNode class.
+  ----------------------------------------------
+*/
+
+/**
+* An AVLTree that keeps duplicate keys. Each distinct key has one node with
+* a count, so a run of duplicates costs no extra nodes or tree depth; in the
+* map case the extra values sit in one vector per node, and in the set case
+* (an empty Value such as MultiSetTag) the count is all there is.
+*
+* size() counts elements. The inherited iterator, find and lower_bound see
+* each key once; value_iterator, beginElements and equal_range visit every
+* element, values of one key in insertion order. remove drops one element.
+*/
+template <typename Key, typename Value,
+          typename Alloc = std::allocator<std::pair<const Key, Value> > >
+class MultiAVLTree : public AVLTree<Key, Value, Alloc>
+{
+public:
+    MultiAVLTree();
+    explicit MultiAVLTree(const Alloc& alloc);
+    MultiAVLTree(const MultiAVLTree& other);
+    MultiAVLTree(MultiAVLTree&& other);
+    MultiAVLTree& operator=(const MultiAVLTree& other);
+    MultiAVLTree& operator=(MultiAVLTree&& other);
+    void swap(MultiAVLTree& other);
+    virtual ~MultiAVLTree();
+
+    virtual void insert(const std::pair<const Key, Value>& new_item);
+    virtual void remove(const Key& key);
+    size_t removeAll(const Key& key);
+    virtual size_t eraseRange(const Key& lo, const Key& hi);
+    virtual void clear();
+    template<typename InputIt>
+    void assignSorted(InputIt first, InputIt last);
+    size_t size() const;
+    size_t distinctKeys() const;
+    size_t count(const Key& key) const;
+    size_t memoryUsage() const;
+
+    /**
+    * Forward iterator over every element. Dereferencing gives a pair of
+    * references, since only a key's first value lives in the node's item.
+    */
+    class value_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::pair<const Key, Value> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::pair<const Key&, Value&> reference;
+
+        // Lets it->first work on the pair of references.
+        class pointer
+        {
+        public:
+            pointer(const reference& item) : item_(item) {}
+            const reference* operator->() const { return &item_; }
+        private:
+            reference item_;
+        };
+
+        value_iterator();
+
+        reference operator*() const;
+        pointer operator->() const;
+
+        bool operator==(const value_iterator& rhs) const;
+        bool operator!=(const value_iterator& rhs) const;
+
+        value_iterator& operator++();
+
+    protected:
+        friend class MultiAVLTree<Key, Value, Alloc>;
+        value_iterator(MultiAVLNode<Key, Value>* node, size_t index, const MultiAVLTree<Key, Value, Alloc>* tree);
+
+        MultiAVLNode<Key, Value>* node_;
+        size_t index_;
+        const MultiAVLTree<Key, Value, Alloc>* tree_;
+    };
+
+    value_iterator beginElements() const;
+    value_iterator endElements() const;
+    std::pair<value_iterator, value_iterator> equal_range(const Key& key) const;
+    void erase(const value_iterator& pos);
+
+protected:
+    typedef MultiAVLNode<Key, Value> NodeType;
+
+    virtual AVLNode<Key, Value>* createNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent);
+    virtual void destroyNode(Node<Key, Value>* node);
+    virtual void swapTree(BinarySearchTree<Key, Value, Alloc>& other);
+    void removeNode(NodeType* node);
+
+    size_t elements_;   // total count over all keys
+};
+
+/**
+* Empty tag to use as Value for a multiset.
+*/
+struct MultiSetTag
+{
+
+};
+
+// Lets print() show multiset trees; there is no value to print.
+inline std::ostream& operator<<(std::ostream& out, const MultiSetTag&)
+{
+    return out;
+}
+
+/*
+  --------------------------------------------------------------
+  Begin implementations for the MultiAVLTree::value_iterator class.
+  --------------------------------------------------------------
+*/
+
+template<typename Key, typename Value, typename Alloc>
+MultiAVLTree<Key, Value, Alloc>::value_iterator::value_iterator() : node_(NULL), index_(0), tree_(NULL)
+{
+
+}
+
+template<typename Key, typename Value, typename Alloc>
+MultiAVLTree<Key, Value, Alloc>::value_iterator::value_iterator(MultiAVLNode<Key, Value>* node, size_t index,
+                                                                const MultiAVLTree<Key, Value, Alloc>* tree) :
+    node_(node), index_(index), tree_(tree)
+{
+
+}
+
+template<typename Key, typename Value, typename Alloc>
+typename MultiAVLTree<Key, Value, Alloc>::value_iterator::reference
+MultiAVLTree<Key, Value, Alloc>::value_iterator::operator*() const
+{
+    return reference(node_->getKey(), node_->valueAt(index_));
+}
+
+template<typename Key, typename Value, typename Alloc>
+typename MultiAVLTree<Key, Value, Alloc>::value_iterator::pointer
+MultiAVLTree<Key, Value, Alloc>::value_iterator::operator->() const
+{
+    return pointer(**this);
+}
+
+template<typename Key, typename Value, typename Alloc>
+bool MultiAVLTree<Key, Value, Alloc>::value_iterator::operator==(const value_iterator& rhs) const
+{
+    return node_ == rhs.node_ && index_ == rhs.index_;
+}
+
+template<typename Key, typename Value, typename Alloc>
+bool MultiAVLTree<Key, Value, Alloc>::value_iterator::operator!=(const value_iterator& rhs) const
+{
+    return !(*this == rhs);
+}
+
+/**
+* Next value of the same key, else the first value of the next key.
+*/
+template<typename Key, typename Value, typename Alloc>
+typename MultiAVLTree<Key, Value, Alloc>::value_iterator&
+MultiAVLTree<Key, Value, Alloc>::value_iterator::operator++()
+{
+    if(++index_ == node_->getCount()){
+      node_ = static_cast<MultiAVLNode<Key, Value>*>(tree_->nextNode(node_));
+      index_ = 0;
+    }
+    return *this;
+}
+
+/*
+  ------------------------------------------------------------
+  End implementations for the MultiAVLTree::value_iterator class.
+  ------------------------------------------------------------
+*/
+
+template<typename Key, typename Value, typename Alloc>
+MultiAVLTree<Key, Value, Alloc>::MultiAVLTree() : AVLTree<Key, Value, Alloc>(), elements_(0)
+{
+
+}
+
+template<typename Key, typename Value, typename Alloc>
+MultiAVLTree<Key, Value, Alloc>::MultiAVLTree(const Alloc& alloc) : AVLTree<Key, Value, Alloc>(alloc), elements_(0)
+{
+
+}
+
+/**
+* Deep copy in O(n); nodes are cloned as MultiAVLNodes, value lists included.
+*/
+template<typename Key, typename Value, typename Alloc>
+MultiAVLTree<Key, Value, Alloc>::MultiAVLTree(const MultiAVLTree<Key, Value, Alloc>& other) :
+    AVLTree<Key, Value, Alloc>(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.get_allocator())),
+    elements_(0)
+{
+    this->template copyFrom<NodeType>(other);
+    this->tombstoneMode_ = other.tombstoneMode_;
+    this->compactThreshold_ = other.compactThreshold_;
+    this->relaxedBound_ = other.relaxedBound_;
+    this->dead_ = other.dead_;
+    elements_ = other.elements_;
+}
+
+/**
+* Move constructor; O(1), leaves other empty.
+*/
+template<typename Key, typename Value, typename Alloc>
+MultiAVLTree<Key, Value, Alloc>::MultiAVLTree(MultiAVLTree<Key, Value, Alloc>&& other) :
+    AVLTree<Key, Value, Alloc>(std::move(other)), elements_(other.elements_)
+{
+    other.elements_ = 0;
+}
+
+template<typename Key, typename Value, typename Alloc>
+MultiAVLTree<Key, Value, Alloc>& MultiAVLTree<Key, Value, Alloc>::operator=(const MultiAVLTree<Key, Value, Alloc>& other)
+{
+    if(this != &other){
+      MultiAVLTree<Key, Value, Alloc> copy(other);
+      this->swapTree(copy);
+    }
+    return *this;
+}
+
+template<typename Key, typename Value, typename Alloc>
+MultiAVLTree<Key, Value, Alloc>& MultiAVLTree<Key, Value, Alloc>::operator=(MultiAVLTree<Key, Value, Alloc>&& other)
+{
+    this->swapTree(other);
+    return *this;
+}
+
+template<typename Key, typename Value, typename Alloc>
+void MultiAVLTree<Key, Value, Alloc>::swap(MultiAVLTree<Key, Value, Alloc>& other)
+{
+    this->swapTree(other);
+}
+
+/**
+* Frees the nodes here so they are freed as MultiAVLNodes.
+*/
+template<typename Key, typename Value, typename Alloc>
+MultiAVLTree<Key, Value, Alloc>::~MultiAVLTree()
+{
+    this->clear();
+}
+
+/**
+* Adds one element. A new key gets a node as usual; a key already present
+* just gains a count (and, in the map case, a value at the end of its list).
+*/
+template<typename Key, typename Value, typename Alloc>
+void MultiAVLTree<Key, Value, Alloc>::insert(const std::pair<const Key, Value>& new_item)
+{
+    NodeType* node = static_cast<NodeType*>(this->internalFind(new_item.first));
+    if(node != nullptr){
+      node->addValue(new_item.second);
+    }
+    else{
+      AVLTree<Key, Value, Alloc>::insert(new_item);
+    }
+    ++elements_;
+}
+
+/**
+* Removes one element with this key, the most recently inserted. Does
+* nothing if the key is not present.
+*/
+template<typename Key, typename Value, typename Alloc>
+void MultiAVLTree<Key, Value, Alloc>::remove(const Key& key)
+{
+    NodeType* node = static_cast<NodeType*>(this->internalFind(key));
+    if(node == nullptr){
+      return;
+    }
+    if(node->getCount() > 1){
+      node->eraseValue(node->getCount() - 1);
+      --elements_;
+    }
+    else{
+      removeNode(node);
+    }
+}
+
+/**
+* Removes every element with this key and returns how many there were.
+*/
+template<typename Key, typename Value, typename Alloc>
+size_t MultiAVLTree<Key, Value, Alloc>::removeAll(const Key& key)
+{
+    NodeType* node = static_cast<NodeType*>(this->internalFind(key));
+    if(node == nullptr){
+      return 0;
+    }
+    size_t removed = node->getCount();
+    removeNode(node);
+    return removed;
+}
+
+/**
+* Removes every element with lo <= key <= hi and returns how many there
+* were. Counting them walks the k keys, as the sweep does anyway.
+*/
+template<typename Key, typename Value, typename Alloc>
+size_t MultiAVLTree<Key, Value, Alloc>::eraseRange(const Key& lo, const Key& hi)
+{
+    size_t removed = 0;
+    if(!(hi < lo)){
+      Node<Key, Value>* node = this->root_;
+      Node<Key, Value>* first = nullptr; // smallest node >= lo
+      while(node != nullptr){
+        if(node->getKey() < lo){
+          node = node->getRight();
+        }
+        else{
+          first = node;
+          node = node->getLeft();
+        }
+      }
+      for(node = this->firstVisible(first); node != nullptr && !(hi < node->getKey()); node = this->nextNode(node)){
+        removed += static_cast<NodeType*>(node)->getCount();
+      }
+    }
+    AVLTree<Key, Value, Alloc>::eraseRange(lo, hi);
+    elements_ -= removed;
+    return removed;
+}
+
+/**
+* Removes the element pos points at; other elements of the same key keep
+* their order. Invalidates iterators.
+*/
+template<typename Key, typename Value, typename Alloc>
+void MultiAVLTree<Key, Value, Alloc>::erase(const value_iterator& pos)
+{
+    if(pos.node_->getCount() > 1){
+      pos.node_->eraseValue(pos.index_);
+      --elements_;
+    }
+    else{
+      removeNode(pos.node_);
+    }
+}
+
+/**
+* Drops a node with all its elements. Its list is freed first, since in
+* tombstone mode the node itself stays behind (and may be revived later
+* with a fresh count).
+*/
+template<typename Key, typename Value, typename Alloc>
+void MultiAVLTree<Key, Value, Alloc>::removeNode(NodeType* node)
+{
+    elements_ -= node->getCount();
+    node->resetValues();
+    Key key = node->getKey(); // the node may be freed while remove still reads the key
+    AVLTree<Key, Value, Alloc>::remove(key);
+}
+
+/**
+* Bulk build from non-decreasing keys; see AVLTree::assignSorted. Each run of
+* equal keys becomes one node holding every value, in input order, as if
+* they had been inserted one by one. Throws std::invalid_argument, leaving
+* the tree empty, if the keys decrease.
+*/
+template<typename Key, typename Value, typename Alloc>
+template<typename InputIt>
+void MultiAVLTree<Key, Value, Alloc>::assignSorted(InputIt first, InputIt last)
+{
+    clear();
+    std::vector<std::pair<Key, Value> > firsts;            // the first element of each key
+    std::vector<std::pair<size_t, Value> > extras;         // (index into firsts, value) for the rest
+    for(; first != last; ++first){
+      if(firsts.empty() || firsts.back().first < first->first){
+        firsts.push_back(std::make_pair(first->first, first->second));
+      }
+      else if(first->first < firsts.back().first){
+        throw std::invalid_argument("assignSorted: keys must be non-decreasing");
+      }
+      else{
+        extras.push_back(std::make_pair(firsts.size() - 1, first->second));
+      }
+    }
+    AVLTree<Key, Value, Alloc>::assignSorted(firsts.begin(), firsts.end());
+
+    // the nodes come out in key order, so one in-order walk places the extras
+    Node<Key, Value>* node = this->getSmallestNode();
+    size_t index = 0;
+    for(size_t i = 0; i < extras.size(); ++i){
+      for(; index < extras[i].first; ++index){
+        node = this->successor(node);
+      }
+      static_cast<NodeType*>(node)->addValue(extras[i].second);
+    }
+    elements_ = firsts.size() + extras.size();
+}
+
+template<typename Key, typename Value, typename Alloc>
+void MultiAVLTree<Key, Value, Alloc>::clear()
+{
+    AVLTree<Key, Value, Alloc>::clear();
+    elements_ = 0;
+}
+
+/**
+* Number of elements, duplicates included.
+*/
+template<typename Key, typename Value, typename Alloc>
+size_t MultiAVLTree<Key, Value, Alloc>::size() const
+{
+    return elements_;
+}
+
+/**
+* Number of distinct keys, i.e. nodes.
+*/
+template<typename Key, typename Value, typename Alloc>
+size_t MultiAVLTree<Key, Value, Alloc>::distinctKeys() const
+{
+    return AVLTree<Key, Value, Alloc>::size();
+}
+
+/**
+* Number of elements with this key; O(log n).
+*/
+template<typename Key, typename Value, typename Alloc>
+size_t MultiAVLTree<Key, Value, Alloc>::count(const Key& key) const
+{
+    NodeType* node = static_cast<NodeType*>(this->internalFind(key));
+    return node == nullptr ? 0 : node->getCount();
+}
+
+/**
+* Node storage plus the value lists hanging off the nodes.
+*/
+template<typename Key, typename Value, typename Alloc>
+size_t MultiAVLTree<Key, Value, Alloc>::memoryUsage() const
+{
+    size_t bytes = AVLTree<Key, Value, Alloc>::memoryUsage();
+    for(NodeType* node = static_cast<NodeType*>(this->firstVisible(this->getSmallestNode())); node != nullptr;
+        node = static_cast<NodeType*>(this->nextNode(node))){
+      bytes += node->extraBytes();
+    }
+    return bytes;
+}
+
+template<typename Key, typename Value, typename Alloc>
+typename MultiAVLTree<Key, Value, Alloc>::value_iterator
+MultiAVLTree<Key, Value, Alloc>::beginElements() const
+{
+    return value_iterator(static_cast<NodeType*>(this->firstVisible(this->getSmallestNode())), 0, this);
+}
+
+template<typename Key, typename Value, typename Alloc>
+typename MultiAVLTree<Key, Value, Alloc>::value_iterator
+MultiAVLTree<Key, Value, Alloc>::endElements() const
+{
+    return value_iterator(NULL, 0, this);
+}
+
+/**
+* The elements with this key, in insertion order: one O(log n) lookup, and
+* the end of the range is simply the next key's first element.
+*/
+template<typename Key, typename Value, typename Alloc>
+std::pair<typename MultiAVLTree<Key, Value, Alloc>::value_iterator, typename MultiAVLTree<Key, Value, Alloc>::value_iterator>
+MultiAVLTree<Key, Value, Alloc>::equal_range(const Key& key) const
+{
+    NodeType* node = static_cast<NodeType*>(this->internalFind(key));
+    if(node == nullptr){
+      return std::make_pair(endElements(), endElements());
+    }
+    return std::make_pair(value_iterator(node, 0, this),
+                          value_iterator(static_cast<NodeType*>(this->nextNode(node)), 0, this));
+}
+
+template<typename Key, typename Value, typename Alloc>
+AVLNode<Key, Value>* MultiAVLTree<Key, Value, Alloc>::createNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent)
+{
+    return this->template allocateNode<NodeType>(key, value, parent);
+}
+
+template<typename Key, typename Value, typename Alloc>
+void MultiAVLTree<Key, Value, Alloc>::destroyNode(Node<Key, Value>* node)
+{
+    this->deallocateNode(static_cast<NodeType*>(node));
+}
+
+template<typename Key, typename Value, typename Alloc>
+void MultiAVLTree<Key, Value, Alloc>::swapTree(BinarySearchTree<Key, Value, Alloc>& other)
+{
+    AVLTree<Key, Value, Alloc>::swapTree(other);
+    std::swap(elements_, static_cast<MultiAVLTree<Key, Value, Alloc>&>(other).elements_);
+}
+
+#endif
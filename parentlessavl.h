@@ -0,0 +1,679 @@
+#ifndef PARENTLESSAVL_H
+#define PARENTLESSAVL_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+
+/**
+* Node of a ParentlessAVLTree: the item, two child links and the balance.
+* No parent pointer and no vtable, so for small keys and values a node is
+* 32 bytes instead of the 48 of an AVLNode.
+*/
+template <typename Key, typename Value>
+class ParentlessAVLNode
+{
+public:
+    ParentlessAVLNode(const Key& key, const Value& value);
+
+    std::pair<const Key, Value> item_;
+    ParentlessAVLNode<Key, Value>* child_[2];   // 0 is left, 1 is right
+    int8_t balance_;                            // height(right) - height(left)
+};
+
+template<typename Key, typename Value>
+ParentlessAVLNode<Key, Value>::ParentlessAVLNode(const Key& key, const Value& value) :
+    item_(key, value), balance_(0)
+{
+    child_[0] = NULL;
+    child_[1] = NULL;
+}
+
+/**
+* An AVL tree without parent pointers. Insert and remove record their
+* descent on a fixed-size path stack and retrace from it; iterators keep
+* their own stack of pending ancestors. Rotations touch two child links per
+* node and nothing else.
+*
+* The tradeoff: an iterator is the size of the stack (MAX_HEIGHT pointers)
+* and there is no O(1) way to step from a node to its neighbours.
+*/
+template <typename Key, typename Value,
+          typename Alloc = std::allocator<std::pair<const Key, Value> > >
+class ParentlessAVLTree
+{
+public:
+    // An AVL tree of height h has at least fib(h + 2) - 1 nodes, so 96
+    // levels cover anything that fits in a 64-bit address space.
+    static const int MAX_HEIGHT = 96;
+
+    ParentlessAVLTree();
+    explicit ParentlessAVLTree(const Alloc& alloc);
+    ParentlessAVLTree(const ParentlessAVLTree& other);
+    ParentlessAVLTree(ParentlessAVLTree&& other);
+    ParentlessAVLTree& operator=(const ParentlessAVLTree& other);
+    ParentlessAVLTree& operator=(ParentlessAVLTree&& other);
+    void swap(ParentlessAVLTree& other);
+    ~ParentlessAVLTree();
+
+    void insert(const std::pair<const Key, Value>& new_item);
+    void remove(const Key& key);
+    void clear();
+    bool isBalanced() const;
+    bool empty() const;
+    size_t size() const;
+    size_t memoryUsage() const;
+
+    typedef ParentlessAVLNode<Key, Value> NodeType;
+
+    /**
+    * In-order forward iterator. The stack holds the current node on top and,
+    * below it, every ancestor still waiting to be visited.
+    */
+    class iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::pair<const Key, Value> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::pair<const Key, Value>* pointer;
+        typedef std::pair<const Key, Value>& reference;
+
+        iterator();
+
+        std::pair<const Key, Value>& operator*() const;
+        std::pair<const Key, Value>* operator->() const;
+
+        bool operator==(const iterator& rhs) const;
+        bool operator!=(const iterator& rhs) const;
+
+        iterator& operator++();
+
+    protected:
+        friend class ParentlessAVLTree<Key, Value, Alloc>;
+        void pushLeftSpine(NodeType* node);
+
+        NodeType* stack_[MAX_HEIGHT];
+        int depth_;
+    };
+
+    iterator begin() const;
+    iterator end() const;
+    iterator find(const Key& key) const;
+    iterator lower_bound(const Key& key) const;
+    Value& operator[](const Key& key);
+    Value const & operator[](const Key& key) const;
+
+protected:
+    NodeType* internalFind(const Key& key) const;
+    static NodeType* rotate(NodeType* node, int dir);
+    static NodeType* rebalance(NodeType* node);
+    void relink(NodeType** path, int depth, NodeType* oldChild, NodeType* newChild);
+    NodeType* cloneSubtree(const NodeType* node);
+    void destroySubtree(NodeType* node);
+    static int checkHeight(const NodeType* node);
+
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<NodeType> NodeAlloc;
+    typedef std::allocator_traits<NodeAlloc> NodeTraits;
+
+    NodeType* root_;
+    size_t size_;
+    NodeAlloc alloc_;
+};
+
+/*
+  -------------------------------------------------
+  Begin implementations for the ParentlessAVLTree::iterator class.
+  -------------------------------------------------
+*/
+
+template<typename Key, typename Value, typename Alloc>
+ParentlessAVLTree<Key, Value, Alloc>::iterator::iterator() : depth_(0)
+{
+
+}
+
+template<typename Key, typename Value, typename Alloc>
+std::pair<const Key, Value>& ParentlessAVLTree<Key, Value, Alloc>::iterator::operator*() const
+{
+    return stack_[depth_ - 1]->item_;
+}
+
+template<typename Key, typename Value, typename Alloc>
+std::pair<const Key, Value>* ParentlessAVLTree<Key, Value, Alloc>::iterator::operator->() const
+{
+    return &(stack_[depth_ - 1]->item_);
+}
+
+/**
+* Two iterators are equal if they are both at the end or on the same node.
+*/
+template<typename Key, typename Value, typename Alloc>
+bool ParentlessAVLTree<Key, Value, Alloc>::iterator::operator==(const iterator& rhs) const
+{
+    if(depth_ == 0 || rhs.depth_ == 0){
+      return depth_ == rhs.depth_;
+    }
+    return stack_[depth_ - 1] == rhs.stack_[rhs.depth_ - 1];
+}
+
+template<typename Key, typename Value, typename Alloc>
+bool ParentlessAVLTree<Key, Value, Alloc>::iterator::operator!=(const iterator& rhs) const
+{
+    return !(*this == rhs);
+}
+
+/**
+* Pops the current node and pushes the left spine of its right subtree;
+* the new top is the in-order successor.
+*/
+template<typename Key, typename Value, typename Alloc>
+typename ParentlessAVLTree<Key, Value, Alloc>::iterator&
+ParentlessAVLTree<Key, Value, Alloc>::iterator::operator++()
+{
+    NodeType* node = stack_[--depth_];
+    pushLeftSpine(node->child_[1]);
+    return *this;
+}
+
+template<typename Key, typename Value, typename Alloc>
+void ParentlessAVLTree<Key, Value, Alloc>::iterator::pushLeftSpine(NodeType* node)
+{
+    while(node != NULL){
+      stack_[depth_++] = node;
+      node = node->child_[0];
+    }
+}
+
+/*
+  -------------------------------------------------
+  End implementations for the ParentlessAVLTree::iterator class.
+  -------------------------------------------------
+*/
+
+template<typename Key, typename Value, typename Alloc>
+ParentlessAVLTree<Key, Value, Alloc>::ParentlessAVLTree() : root_(NULL), size_(0), alloc_()
+{
+
+}
+
+template<typename Key, typename Value, typename Alloc>
+ParentlessAVLTree<Key, Value, Alloc>::ParentlessAVLTree(const Alloc& alloc) : root_(NULL), size_(0), alloc_(alloc)
+{
+
+}
+
+/**
+* Deep copy in O(n); the recursion is bounded by the height.
+*/
+template<typename Key, typename Value, typename Alloc>
+ParentlessAVLTree<Key, Value, Alloc>::ParentlessAVLTree(const ParentlessAVLTree<Key, Value, Alloc>& other) :
+    root_(NULL), size_(0), alloc_(NodeTraits::select_on_container_copy_construction(other.alloc_))
+{
+    root_ = cloneSubtree(other.root_);
+    size_ = other.size_;
+}
+
+template<typename Key, typename Value, typename Alloc>
+ParentlessAVLTree<Key, Value, Alloc>::ParentlessAVLTree(ParentlessAVLTree<Key, Value, Alloc>&& other) :
+    root_(other.root_), size_(other.size_), alloc_(std::move(other.alloc_))
+{
+    other.root_ = NULL;
+    other.size_ = 0;
+}
+
+template<typename Key, typename Value, typename Alloc>
+ParentlessAVLTree<Key, Value, Alloc>&
+ParentlessAVLTree<Key, Value, Alloc>::operator=(const ParentlessAVLTree<Key, Value, Alloc>& other)
+{
+    if(this != &other){
+      ParentlessAVLTree<Key, Value, Alloc> copy(other);
+      swap(copy);
+    }
+    return *this;
+}
+
+template<typename Key, typename Value, typename Alloc>
+ParentlessAVLTree<Key, Value, Alloc>&
+ParentlessAVLTree<Key, Value, Alloc>::operator=(ParentlessAVLTree<Key, Value, Alloc>&& other)
+{
+    swap(other);
+    return *this;
+}
+
+template<typename Key, typename Value, typename Alloc>
+void ParentlessAVLTree<Key, Value, Alloc>::swap(ParentlessAVLTree<Key, Value, Alloc>& other)
+{
+    std::swap(root_, other.root_);
+    std::swap(size_, other.size_);
+    std::swap(alloc_, other.alloc_);
+}
+
+template<typename Key, typename Value, typename Alloc>
+ParentlessAVLTree<Key, Value, Alloc>::~ParentlessAVLTree()
+{
+    clear();
+}
+
+/*
+ * If key is already in the tree, the value is overwritten.
+ * The descent is recorded in path/dirs and retraced bottom-up until a
+ * subtree's height stops changing; at most one (single or double)
+ * rotation is needed.
+ */
+template<typename Key, typename Value, typename Alloc>
+void ParentlessAVLTree<Key, Value, Alloc>::insert(const std::pair<const Key, Value>& new_item)
+{
+    NodeType* path[MAX_HEIGHT];
+    int dirs[MAX_HEIGHT];
+    int depth = 0;
+
+    NodeType* currentNode = root_;
+    while(currentNode != NULL){
+      if(new_item.first < currentNode->item_.first){
+        dirs[depth] = 0;
+      }
+      else if(currentNode->item_.first < new_item.first){
+        dirs[depth] = 1;
+      }
+      else{ // key exists so just update the value
+        currentNode->item_.second = new_item.second;
+        return;
+      }
+      path[depth] = currentNode;
+      currentNode = currentNode->child_[dirs[depth]];
+      ++depth;
+    }
+
+    NodeType* newNode = NodeTraits::allocate(alloc_, 1);
+    try{
+      NodeTraits::construct(alloc_, newNode, new_item.first, new_item.second);
+    }
+    catch(...){
+      NodeTraits::deallocate(alloc_, newNode, 1);
+      throw;
+    }
+    ++size_;
+    if(depth == 0){
+      root_ = newNode;
+      return;
+    }
+    path[depth - 1]->child_[dirs[depth - 1]] = newNode;
+
+    for(int i = depth - 1; i >= 0; --i){ // the subtree under path[i] grew on side dirs[i]
+      NodeType* node = path[i];
+      node->balance_ += dirs[i] ? 1 : -1;
+      if(node->balance_ == 0){ // height unchanged
+        break;
+      }
+      if(node->balance_ == 2 || node->balance_ == -2){ // a rotation restores the old height
+        relink(path, i, node, rebalance(node));
+        break;
+      }
+    }
+}
+
+/*
+ * A node with two children is replaced by its in-order predecessor, which
+ * is unlinked from the bottom of the left subtree. The path then runs all
+ * the way to where the predecessor used to be, and retracing continues
+ * while subtrees keep getting shorter.
+ */
+template<typename Key, typename Value, typename Alloc>
+void ParentlessAVLTree<Key, Value, Alloc>::remove(const Key& key)
+{
+    NodeType* path[MAX_HEIGHT];
+    int dirs[MAX_HEIGHT];
+    int depth = 0;
+
+    NodeType* node = root_;
+    while(node != NULL){
+      if(key < node->item_.first){
+        dirs[depth] = 0;
+      }
+      else if(node->item_.first < key){
+        dirs[depth] = 1;
+      }
+      else{
+        break;
+      }
+      path[depth] = node;
+      node = node->child_[dirs[depth]];
+      ++depth;
+    }
+    if(node == NULL){ // nothing to remove
+      return;
+    }
+
+    if(node->child_[0] != NULL && node->child_[1] != NULL){
+      int nodeIndex = depth; // the predecessor will take this slot on the path
+      path[depth] = node;
+      dirs[depth] = 0;
+      ++depth;
+      NodeType* pred = node->child_[0];
+      while(pred->child_[1] != NULL){
+        path[depth] = pred;
+        dirs[depth] = 1;
+        ++depth;
+        pred = pred->child_[1];
+      }
+
+      // unlink pred (it has no right child), then put it where node was
+      path[depth - 1]->child_[dirs[depth - 1]] = pred->child_[0];
+      pred->child_[0] = node->child_[0];
+      pred->child_[1] = node->child_[1];
+      pred->balance_ = node->balance_;
+      relink(path, nodeIndex, node, pred);
+      path[nodeIndex] = pred;
+    }
+    else{
+      NodeType* child = node->child_[0] != NULL ? node->child_[0] : node->child_[1];
+      relink(path, depth, node, child);
+    }
+
+    NodeTraits::destroy(alloc_, node);
+    NodeTraits::deallocate(alloc_, node, 1);
+    --size_;
+
+    for(int i = depth - 1; i >= 0; --i){ // the subtree under path[i] shrank on side dirs[i]
+      NodeType* current = path[i];
+      current->balance_ += dirs[i] ? -1 : 1;
+      if(current->balance_ == 1 || current->balance_ == -1){ // height unchanged
+        break;
+      }
+      if(current->balance_ == 2 || current->balance_ == -2){
+        NodeType* top = rebalance(current);
+        relink(path, i, current, top);
+        if(top->balance_ != 0){ // the rotation kept the old height
+          break;
+        }
+      }
+    }
+}
+
+/**
+* Removes every item.
+*/
+template<typename Key, typename Value, typename Alloc>
+void ParentlessAVLTree<Key, Value, Alloc>::clear()
+{
+    destroySubtree(root_);
+    root_ = NULL;
+    size_ = 0;
+}
+
+/**
+* Return true iff every node's stored balance matches its subtrees and is
+* within [-1, 1].
+*/
+template<typename Key, typename Value, typename Alloc>
+bool ParentlessAVLTree<Key, Value, Alloc>::isBalanced() const
+{
+    return checkHeight(root_) >= 0;
+}
+
+template<typename Key, typename Value, typename Alloc>
+bool ParentlessAVLTree<Key, Value, Alloc>::empty() const
+{
+    return size_ == 0;
+}
+
+template<typename Key, typename Value, typename Alloc>
+size_t ParentlessAVLTree<Key, Value, Alloc>::size() const
+{
+    return size_;
+}
+
+/**
+* Returns the number of bytes of node storage the tree holds
+*/
+template<typename Key, typename Value, typename Alloc>
+size_t ParentlessAVLTree<Key, Value, Alloc>::memoryUsage() const
+{
+    return size_ * sizeof(NodeType);
+}
+
+template<typename Key, typename Value, typename Alloc>
+typename ParentlessAVLTree<Key, Value, Alloc>::iterator
+ParentlessAVLTree<Key, Value, Alloc>::begin() const
+{
+    iterator it;
+    it.pushLeftSpine(root_);
+    return it;
+}
+
+template<typename Key, typename Value, typename Alloc>
+typename ParentlessAVLTree<Key, Value, Alloc>::iterator
+ParentlessAVLTree<Key, Value, Alloc>::end() const
+{
+    return iterator();
+}
+
+/**
+* Returns an iterator to the item with the given key or end(). Nodes where
+* the search turned left are the ones still ahead of the key in order, so
+* they are exactly what the iterator's stack needs.
+*/
+template<typename Key, typename Value, typename Alloc>
+typename ParentlessAVLTree<Key, Value, Alloc>::iterator
+ParentlessAVLTree<Key, Value, Alloc>::find(const Key& key) const
+{
+    iterator it;
+    NodeType* currentNode = root_;
+    while(currentNode != NULL){
+      if(key < currentNode->item_.first){
+        it.stack_[it.depth_++] = currentNode;
+        currentNode = currentNode->child_[0];
+      }
+      else if(currentNode->item_.first < key){
+        currentNode = currentNode->child_[1];
+      }
+      else{
+        it.stack_[it.depth_++] = currentNode;
+        return it;
+      }
+    }
+    return end();
+}
+
+/**
+* Returns an iterator to the first item whose key is not less than key
+*/
+template<typename Key, typename Value, typename Alloc>
+typename ParentlessAVLTree<Key, Value, Alloc>::iterator
+ParentlessAVLTree<Key, Value, Alloc>::lower_bound(const Key& key) const
+{
+    iterator it;
+    NodeType* currentNode = root_;
+    while(currentNode != NULL){
+      if(currentNode->item_.first < key){ // everything here and to the left is too small
+        currentNode = currentNode->child_[1];
+      }
+      else{ // candidate; smaller candidates are on the left
+        it.stack_[it.depth_++] = currentNode;
+        currentNode = currentNode->child_[0];
+      }
+    }
+    return it;
+}
+
+/**
+ * @precondition The key exists in the map
+ * Returns the value associated with the key
+ */
+template<typename Key, typename Value, typename Alloc>
+Value& ParentlessAVLTree<Key, Value, Alloc>::operator[](const Key& key)
+{
+    NodeType* node = internalFind(key);
+    if(node == NULL) throw std::out_of_range("Invalid key");
+    return node->item_.second;
+}
+
+template<typename Key, typename Value, typename Alloc>
+Value const & ParentlessAVLTree<Key, Value, Alloc>::operator[](const Key& key) const
+{
+    NodeType* node = internalFind(key);
+    if(node == NULL) throw std::out_of_range("Invalid key");
+    return node->item_.second;
+}
+
+template<typename Key, typename Value, typename Alloc>
+typename ParentlessAVLTree<Key, Value, Alloc>::NodeType*
+ParentlessAVLTree<Key, Value, Alloc>::internalFind(const Key& key) const
+{
+    NodeType* currentNode = root_;
+    while(currentNode != NULL){
+      if(key < currentNode->item_.first){
+        currentNode = currentNode->child_[0];
+      }
+      else if(currentNode->item_.first < key){
+        currentNode = currentNode->child_[1];
+      }
+      else{
+        return currentNode;
+      }
+    }
+    return NULL;
+}
+
+/**
+* Rotates node down towards dir (0 left, 1 right) and returns the child that
+* took its place. Only links are changed; balances are up to the caller.
+*/
+template<typename Key, typename Value, typename Alloc>
+typename ParentlessAVLTree<Key, Value, Alloc>::NodeType*
+ParentlessAVLTree<Key, Value, Alloc>::rotate(NodeType* node, int dir)
+{
+    NodeType* child = node->child_[1 - dir];
+    node->child_[1 - dir] = child->child_[dir];
+    child->child_[dir] = node;
+    return child;
+}
+
+/**
+* Fixes a node whose balance is +-2 with a single or double rotation and
+* returns the new subtree root with all balances set. The new root's balance
+* is 0 unless the heavy child was itself balanced (only possible on remove),
+* in which case the subtree kept its height.
+*/
+template<typename Key, typename Value, typename Alloc>
+typename ParentlessAVLTree<Key, Value, Alloc>::NodeType*
+ParentlessAVLTree<Key, Value, Alloc>::rebalance(NodeType* node)
+{
+    int heavy = node->balance_ > 0 ? 1 : 0;      // side that is too tall
+    int sign = heavy ? 1 : -1;
+    NodeType* child = node->child_[heavy];
+
+    if(child->balance_ * sign >= 0){ // outside case, single rotation
+      NodeType* top = rotate(node, 1 - heavy);
+      if(child->balance_ == 0){
+        node->balance_ = sign;
+        child->balance_ = -sign;
+      }
+      else{
+        node->balance_ = 0;
+        child->balance_ = 0;
+      }
+      return top;
+    }
+
+    // inside case: the grandchild comes up two levels
+    NodeType* grandchild = child->child_[1 - heavy];
+    node->child_[heavy] = rotate(child, heavy);
+    NodeType* top = rotate(node, 1 - heavy);
+    if(grandchild->balance_ == sign){
+      node->balance_ = -sign;
+      child->balance_ = 0;
+    }
+    else if(grandchild->balance_ == -sign){
+      node->balance_ = 0;
+      child->balance_ = sign;
+    }
+    else{
+      node->balance_ = 0;
+      child->balance_ = 0;
+    }
+    grandchild->balance_ = 0;
+    return top;
+}
+
+/**
+* Replaces oldChild, found at path[depth], with newChild in its parent
+* (path[depth - 1]) or at the root.
+*/
+template<typename Key, typename Value, typename Alloc>
+void ParentlessAVLTree<Key, Value, Alloc>::relink(NodeType** path, int depth, NodeType* oldChild, NodeType* newChild)
+{
+    if(depth == 0){
+      root_ = newChild;
+    }
+    else if(path[depth - 1]->child_[0] == oldChild){
+      path[depth - 1]->child_[0] = newChild;
+    }
+    else{
+      path[depth - 1]->child_[1] = newChild;
+    }
+}
+
+template<typename Key, typename Value, typename Alloc>
+typename ParentlessAVLTree<Key, Value, Alloc>::NodeType*
+ParentlessAVLTree<Key, Value, Alloc>::cloneSubtree(const NodeType* node)
+{
+    if(node == NULL){
+      return NULL;
+    }
+    NodeType* copy = NodeTraits::allocate(alloc_, 1);
+    try{
+      NodeTraits::construct(alloc_, copy, node->item_.first, node->item_.second);
+    }
+    catch(...){
+      NodeTraits::deallocate(alloc_, copy, 1);
+      throw;
+    }
+    copy->balance_ = node->balance_;
+    try{
+      copy->child_[0] = cloneSubtree(node->child_[0]);
+      copy->child_[1] = cloneSubtree(node->child_[1]);
+    }
+    catch(...){ // free this subtree's copies before passing it on
+      destroySubtree(copy);
+      throw;
+    }
+    return copy;
+}
+
+template<typename Key, typename Value, typename Alloc>
+void ParentlessAVLTree<Key, Value, Alloc>::destroySubtree(NodeType* node)
+{
+    if(node == NULL){
+      return;
+    }
+    destroySubtree(node->child_[0]);
+    destroySubtree(node->child_[1]);
+    NodeTraits::destroy(alloc_, node);
+    NodeTraits::deallocate(alloc_, node, 1);
+}
+
+/**
+* Height of the subtree, or -1 if any balance in it is wrong.
+*/
+template<typename Key, typename Value, typename Alloc>
+int ParentlessAVLTree<Key, Value, Alloc>::checkHeight(const NodeType* node)
+{
+    if(node == NULL){
+      return 0;
+    }
+    int left = checkHeight(node->child_[0]);
+    int right = checkHeight(node->child_[1]);
+    if(left < 0 || right < 0 || right - left != node->balance_ || right - left > 1 || left - right > 1){
+      return -1;
+    }
+    return 1 + (left > right ? left : right);
+}
+
+#endif
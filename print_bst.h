@@ -3,6 +3,7 @@
 #include <map>
 #include <vector>
 #include <cstdint>
+#include <utility>
 
 #ifndef PRINT_BST_H
 #define PRINT_BST_H
@@ -13,12 +14,30 @@
 // maximum depth of tree to actually print.
 #define PPBST_MAX_HEIGHT 6
 
+// Prints one key in the placeholder list. Pair keys (intervals, composite
+// keys) have no operator<< of their own, so they get one here.
+template<typename Key>
+void printKey(std::ostream& out, const Key& key)
+{
+    out << key;
+}
+
+template<typename First, typename Second>
+void printKey(std::ostream& out, const std::pair<First, Second>& key)
+{
+    out << '<';
+    printKey(out, key.first);
+    out << ", ";
+    printKey(out, key.second);
+    out << '>';
+}
+
 // Returns the node's distance from the given root.
 // 1 means that it is the root.
 // Returns -1 (not found) if the distance is more than PPBST_MAX_HEIGHT,
 // or -2 if the tree is inconsistent.
-template<typename Key, typename Value>
-int getNodeDepth(BinarySearchTree<Key, Value> const & tree, Node<Key, Value> * root, Node<Key, Value> * node)
+template<typename Key, typename Value, typename Alloc>
+int getNodeDepth(BinarySearchTree<Key, Value, Alloc> const & tree, Node<Key, Value> * root, Node<Key, Value> * node)
 {
     int dist = 1;
 
@@ -92,8 +111,8 @@ int getSubtreeHeight(Node<Key, Value> * root, int recursionDepth = 1)
 
     */
 
-template<typename Key, typename Value>
-void BinarySearchTree<Key, Value>::printRoot (Node<Key, Value>* root) const
+template<typename Key, typename Value, typename Alloc>
+void BinarySearchTree<Key, Value, Alloc>::printRoot (Node<Key, Value>* root) const
 {
     // special case for empty trees:
     if(root == nullptr)
@@ -113,6 +132,7 @@ void BinarySearchTree<Key, Value>::printRoot (Node<Key, Value>* root) const
     // ----------------------------------------------------------------------
     uint32_t printedTreeHeight = getSubtreeHeight(root);
     bool clippedFinalElements = false;
+    bool printedDeadElements = false;
 
     // with the width of a standard terminal, we can only print 2^5 = 32 elements
     if(printedTreeHeight > PPBST_MAX_HEIGHT)
@@ -130,7 +150,7 @@ void BinarySearchTree<Key, Value>::printRoot (Node<Key, Value>* root) const
     std::map<Key, uint8_t> valuePlaceholders;
 
     uint8_t nextPlaceHolderVal = 1;
-    for(typename BinarySearchTree<Key, Value>::iterator treeIter = this->begin(); treeIter != this->end(); ++treeIter)
+    for(typename BinarySearchTree<Key, Value, Alloc>::iterator treeIter = this->begin(); treeIter != this->end(); ++treeIter)
     {
 
         if(getNodeDepth(*this, root, treeIter.current_) != -1)
@@ -165,6 +185,12 @@ void BinarySearchTree<Key, Value>::printRoot (Node<Key, Value>* root) const
             {
                 std::cout << "    ";
             }
+            else if(!isVisible(currRowNodes[elementIndex]))
+            {
+                // removed (tombstone), still linked in until compaction
+                std::cout << "[xx]";
+                printedDeadElements = true;
+            }
             else
             {
                 uint16_t placeholder = valuePlaceholders[currRowNodes[elementIndex]->getItem().first];
@@ -260,6 +286,10 @@ void BinarySearchTree<Key, Value>::printRoot (Node<Key, Value>* root) const
     {
         std::cout << "(deeper levels omitted due to space limitations)" << std::endl;
     }
+    if(printedDeadElements)
+    {
+        std::cout << "([xx] marks removed nodes awaiting compaction)" << std::endl;
+    }
 
 
     if(!std::is_same<Key, uint8_t>::value) // print placeholder explanations if needed:
@@ -271,9 +301,11 @@ void BinarySearchTree<Key, Value>::printRoot (Node<Key, Value>* root) const
 
             // print element with original cout flags
             std::cout.flags(origCoutState);
-            std::cout << '(' << placeholdersIter->first << ", ";
+            std::cout << '(';
+            printKey(std::cout, placeholdersIter->first);
+            std::cout << ", ";
 
-            typename BinarySearchTree<Key, Value>::iterator elementIter = this->find(placeholdersIter->first);
+            typename BinarySearchTree<Key, Value, Alloc>::iterator elementIter = this->find(placeholdersIter->first);
             if(elementIter == this->end())
             {
                 std::cout << "<error: lookup failed>";
@@ -0,0 +1,478 @@
+#ifndef RBBST_H
+#define RBBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include <stdexcept>
+#include "bst.h"
+
+/**
+* A special kind of node for a red-black tree, which adds a color bit.
+*/
+template <typename Key, typename Value>
+class RBNode : public Node<Key, Value>
+{
+public:
+    enum Color { RED = 0, BLACK = 1 };
+
+    // Constructor/destructor.
+    RBNode(const Key& key, const Value& value, RBNode<Key, Value>* parent);
+    virtual ~RBNode();
+
+    // Getter/setter for the node's color.
+    Color getColor() const;
+    void setColor(Color color);
+    bool isRed() const;
+
+    // Getters for parent, left, and right, redefined to return RBNodes.
+    virtual RBNode<Key, Value>* getParent() const override;
+    virtual RBNode<Key, Value>* getLeft() const override;
+    virtual RBNode<Key, Value>* getRight() const override;
+
+protected:
+    uint8_t color_;
+};
+
+/*
+  -------------------------------------------------
+  Begin implementations for the RBNode class.
+  -------------------------------------------------
+*/
+
+/**
+* New nodes start out red.
+*/
+template<class Key, class Value>
+RBNode<Key, Value>::RBNode(const Key& key, const Value& value, RBNode<Key, Value> *parent) :
+    Node<Key, Value>(key, value, parent), color_(RED)
+{
+
+}
+
+/**
+* A destructor which does nothing.
+*/
+template<class Key, class Value>
+RBNode<Key, Value>::~RBNode()
+{
+
+}
+
+/**
+* A getter for the color of a RBNode.
+*/
+template<class Key, class Value>
+typename RBNode<Key, Value>::Color RBNode<Key, Value>::getColor() const
+{
+    return static_cast<Color>(color_);
+}
+
+/**
+* A setter for the color of a RBNode.
+*/
+template<class Key, class Value>
+void RBNode<Key, Value>::setColor(Color color)
+{
+    color_ = color;
+}
+
+/**
+* True if the node is red.
+*/
+template<class Key, class Value>
+bool RBNode<Key, Value>::isRed() const
+{
+    return color_ == RED;
+}
+
+/**
+* Overridden to static_cast to RBNode, as in AVLNode.
+*/
+template<class Key, class Value>
+RBNode<Key, Value> *RBNode<Key, Value>::getParent() const
+{
+    return static_cast<RBNode<Key, Value>*>(this->parent_);
+}
+
+/**
+* Overridden for the same reasons as above.
+*/
+template<class Key, class Value>
+RBNode<Key, Value> *RBNode<Key, Value>::getLeft() const
+{
+    return static_cast<RBNode<Key, Value>*>(this->child_[0]);
+}
+
+/**
+* Overridden for the same reasons as above.
+*/
+template<class Key, class Value>
+RBNode<Key, Value> *RBNode<Key, Value>::getRight() const
+{
+    return static_cast<RBNode<Key, Value>*>(this->child_[1]);
+}
+
+/*
+  -----------------------------------------------
+  End implementations for the RBNode class.
+  -----------------------------------------------
+*/
+
+/**
+* A red-black tree. Inserts use at most two rotations and removes at most
+* three; the rest of the fix-up work is recoloring, so the retrace after a
+* remove is much cheaper than AVLTree's.
+*/
+template <class Key, class Value,
+          class Alloc = std::allocator<std::pair<const Key, Value> > >
+class RBTree : public BinarySearchTree<Key, Value, Alloc>
+{
+public:
+    RBTree();
+    explicit RBTree(const Alloc& alloc);
+    RBTree(const RBTree& other);
+    RBTree(RBTree&& other);
+    RBTree& operator=(const RBTree& other);
+    RBTree& operator=(RBTree&& other);
+    void swap(RBTree& other);
+    virtual ~RBTree();
+    virtual void insert (const std::pair<const Key, Value> &new_item);
+    virtual void remove(const Key& key);
+    virtual size_t eraseRange(const Key& lo, const Key& hi);
+    virtual void setScapegoatAlpha(double alpha);
+protected:
+    virtual void nodeSwap( RBNode<Key,Value>* n1, RBNode<Key,Value>* n2);
+    virtual void destroyNode(Node<Key, Value>* node);
+
+    // Helper functions
+    void insertFixup(RBNode<Key, Value>* node);
+    void removeFixup(RBNode<Key, Value>* node, RBNode<Key, Value>* parentNode);
+    static bool isRed(RBNode<Key, Value>* node);
+};
+
+template<class Key, class Value, class Alloc>
+RBTree<Key, Value, Alloc>::RBTree() : BinarySearchTree<Key, Value, Alloc>()
+{
+
+}
+
+template<class Key, class Value, class Alloc>
+RBTree<Key, Value, Alloc>::RBTree(const Alloc& alloc) : BinarySearchTree<Key, Value, Alloc>(alloc)
+{
+
+}
+
+/**
+* Deep copy in O(n); nodes are cloned as RBNodes.
+*/
+template<class Key, class Value, class Alloc>
+RBTree<Key, Value, Alloc>::RBTree(const RBTree<Key, Value, Alloc>& other) :
+    BinarySearchTree<Key, Value, Alloc>(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.get_allocator()))
+{
+    this->template copyFrom<RBNode<Key, Value> >(other);
+}
+
+/**
+* Move constructor; O(1), leaves other empty.
+*/
+template<class Key, class Value, class Alloc>
+RBTree<Key, Value, Alloc>::RBTree(RBTree<Key, Value, Alloc>&& other) :
+    BinarySearchTree<Key, Value, Alloc>(std::move(other))
+{
+
+}
+
+template<class Key, class Value, class Alloc>
+RBTree<Key, Value, Alloc>& RBTree<Key, Value, Alloc>::operator=(const RBTree<Key, Value, Alloc>& other)
+{
+    if(this != &other){
+      RBTree<Key, Value, Alloc> copy(other);
+      this->swapTree(copy);
+    }
+    return *this;
+}
+
+/**
+* Move assignment in O(1) by swapping contents.
+*/
+template<class Key, class Value, class Alloc>
+RBTree<Key, Value, Alloc>& RBTree<Key, Value, Alloc>::operator=(RBTree<Key, Value, Alloc>&& other)
+{
+    this->swapTree(other);
+    return *this;
+}
+
+template<class Key, class Value, class Alloc>
+void RBTree<Key, Value, Alloc>::swap(RBTree<Key, Value, Alloc>& other)
+{
+    this->swapTree(other);
+}
+
+/**
+* Frees the nodes here so they are freed as RBNodes.
+*/
+template<class Key, class Value, class Alloc>
+RBTree<Key, Value, Alloc>::~RBTree()
+{
+    this->clear();
+}
+
+/*
+ * Recall: If key is already in the tree, you should
+ * overwrite the current value with the updated value.
+ */
+template<class Key, class Value, class Alloc>
+void RBTree<Key, Value, Alloc>::insert (const std::pair<const Key, Value> &new_item)
+{
+    RBNode<Key, Value>* currentNode = static_cast<RBNode<Key, Value>*>(this->root_);
+    RBNode<Key, Value>* parentNode = nullptr;
+
+    while(currentNode != nullptr){ // find the insertion point
+      parentNode = currentNode;
+      if(new_item.first < currentNode->getKey()){
+        currentNode = currentNode->getLeft();
+      }
+      else if(new_item.first > currentNode->getKey()){
+        currentNode = currentNode->getRight();
+      }
+      else{ // key already exists so just update the value
+        currentNode->setValue(new_item.second);
+        return;
+      }
+    }
+
+    RBNode<Key, Value>* newNode = this->template allocateNode<RBNode<Key, Value> >(new_item.first, new_item.second, parentNode);
+    ++this->size_;
+    if(parentNode == nullptr){
+      this->root_ = newNode;
+    }
+    else if(new_item.first < parentNode->getKey()){
+      parentNode->setLeft(newNode);
+    }
+    else{
+      parentNode->setRight(newNode);
+    }
+    insertFixup(newNode);
+}
+
+/*
+ * Recall: The writeup specifies that if a node has 2 children you
+ * should swap with the predecessor and then remove.
+ */
+template<class Key, class Value, class Alloc>
+void RBTree<Key, Value, Alloc>::remove(const Key& key)
+{
+    RBNode<Key, Value>* node = static_cast<RBNode<Key, Value>*>(this->internalFind(key));
+    if(node == nullptr){
+      return;
+    }
+
+    if(node->getLeft() != nullptr && node->getRight() != nullptr){ // swap with the predecessor, colors stay put
+      RBNode<Key, Value>* predecessorNode = static_cast<RBNode<Key, Value>*>(this->predecessor(node));
+      this->nodeSwap(node, predecessorNode);
+    }
+
+    RBNode<Key, Value>* childNode = (node->getLeft() != nullptr) ? node->getLeft() : node->getRight();
+    RBNode<Key, Value>* parentNode = node->getParent();
+    if(childNode != nullptr){
+      childNode->setParent(parentNode);
+    }
+
+    if(parentNode == nullptr){
+      this->root_ = childNode;
+    }
+    else if(parentNode->getLeft() == node){
+      parentNode->setLeft(childNode);
+    }
+    else{
+      parentNode->setRight(childNode);
+    }
+
+    bool removedBlack = !node->isRed();
+    this->destroyNode(node);
+    --this->size_;
+
+    if(removedBlack){ // a black node left the path so the black heights need repairing
+      removeFixup(childNode, parentNode);
+    }
+}
+
+/**
+* Scapegoat rebuilds would relink nodes without recoloring them and break the
+* black-height invariant, so only 0 (off) is accepted.
+*/
+template<class Key, class Value, class Alloc>
+void RBTree<Key, Value, Alloc>::setScapegoatAlpha(double alpha)
+{
+    if(alpha != 0){
+      throw std::invalid_argument("RBTree keeps its own balance; scapegoat mode is not supported");
+    }
+}
+
+/**
+* Removes the range one key at a time, O(k log n). The unbalanced split in
+* BinarySearchTree::eraseRange would break the coloring, and there is no
+* red-black split/join here yet.
+*/
+template<class Key, class Value, class Alloc>
+size_t RBTree<Key, Value, Alloc>::eraseRange(const Key& lo, const Key& hi)
+{
+    std::vector<Key> keys;
+    if(!(hi < lo)){
+      for(typename BinarySearchTree<Key, Value, Alloc>::iterator it = this->lower_bound(lo);
+          it != this->end() && !(hi < it->first); ++it){
+        keys.push_back(it->first);
+      }
+    }
+    for(size_t i = 0; i < keys.size(); ++i){
+      remove(keys[i]);
+    }
+    return keys.size();
+}
+
+template<class Key, class Value, class Alloc>
+void RBTree<Key, Value, Alloc>::nodeSwap( RBNode<Key,Value>* n1, RBNode<Key,Value>* n2)
+{
+    BinarySearchTree<Key, Value, Alloc>::nodeSwap(n1, n2);
+    typename RBNode<Key, Value>::Color tempC = n1->getColor();
+    n1->setColor(n2->getColor());
+    n2->setColor(tempC);
+}
+
+template<class Key, class Value, class Alloc>
+void RBTree<Key, Value, Alloc>::destroyNode(Node<Key, Value>* node)
+{
+    this->deallocateNode(static_cast<RBNode<Key, Value>*>(node));
+}
+
+/**
+* NULL leaves count as black.
+*/
+template<class Key, class Value, class Alloc>
+bool RBTree<Key, Value, Alloc>::isRed(RBNode<Key, Value>* node)
+{
+    return node != nullptr && node->isRed();
+}
+
+/**
+* Fixes a red node with a red parent. Recolors while the uncle is red, then
+* finishes with one or two rotations.
+*/
+template<class Key, class Value, class Alloc>
+void RBTree<Key, Value, Alloc>::insertFixup(RBNode<Key, Value>* node)
+{
+    while(isRed(node->getParent())){
+      RBNode<Key, Value>* parentNode = node->getParent();
+      RBNode<Key, Value>* grandparent = parentNode->getParent(); // exists since the root is black
+
+      if(parentNode == grandparent->getLeft()){
+        RBNode<Key, Value>* uncle = grandparent->getRight();
+        if(isRed(uncle)){ // push the red up and keep going
+          parentNode->setColor(RBNode<Key, Value>::BLACK);
+          uncle->setColor(RBNode<Key, Value>::BLACK);
+          grandparent->setColor(RBNode<Key, Value>::RED);
+          node = grandparent;
+          continue;
+        }
+        if(node == parentNode->getRight()){ // zig zag becomes zig zig
+          this->rotateLeft(parentNode);
+          node = parentNode;
+          parentNode = node->getParent();
+        }
+        parentNode->setColor(RBNode<Key, Value>::BLACK);
+        grandparent->setColor(RBNode<Key, Value>::RED);
+        this->rotateRight(grandparent);
+      }
+      else{
+        RBNode<Key, Value>* uncle = grandparent->getLeft();
+        if(isRed(uncle)){
+          parentNode->setColor(RBNode<Key, Value>::BLACK);
+          uncle->setColor(RBNode<Key, Value>::BLACK);
+          grandparent->setColor(RBNode<Key, Value>::RED);
+          node = grandparent;
+          continue;
+        }
+        if(node == parentNode->getLeft()){
+          this->rotateRight(parentNode);
+          node = parentNode;
+          parentNode = node->getParent();
+        }
+        parentNode->setColor(RBNode<Key, Value>::BLACK);
+        grandparent->setColor(RBNode<Key, Value>::RED);
+        this->rotateLeft(grandparent);
+      }
+    }
+    static_cast<RBNode<Key, Value>*>(this->root_)->setColor(RBNode<Key, Value>::BLACK);
+}
+
+/**
+* Repairs a missing black on the path through node (which may be NULL, hence
+* the explicit parent). Recolors upward until a red node or the root absorbs
+* the deficit; at most three rotations happen in total.
+*/
+template<class Key, class Value, class Alloc>
+void RBTree<Key, Value, Alloc>::removeFixup(RBNode<Key, Value>* node, RBNode<Key, Value>* parentNode)
+{
+    while(node != this->root_ && !isRed(node)){
+      if(node == parentNode->getLeft()){
+        RBNode<Key, Value>* sibling = parentNode->getRight(); // never NULL, it carries the extra black
+        if(isRed(sibling)){ // make the sibling black
+          sibling->setColor(RBNode<Key, Value>::BLACK);
+          parentNode->setColor(RBNode<Key, Value>::RED);
+          this->rotateLeft(parentNode);
+          sibling = parentNode->getRight();
+        }
+        if(!isRed(sibling->getLeft()) && !isRed(sibling->getRight())){ // recolor and move up
+          sibling->setColor(RBNode<Key, Value>::RED);
+          node = parentNode;
+          parentNode = node->getParent();
+          continue;
+        }
+        if(!isRed(sibling->getRight())){ // near nephew is red, rotate it outward
+          sibling->getLeft()->setColor(RBNode<Key, Value>::BLACK);
+          sibling->setColor(RBNode<Key, Value>::RED);
+          this->rotateRight(sibling);
+          sibling = parentNode->getRight();
+        }
+        sibling->setColor(parentNode->getColor());
+        parentNode->setColor(RBNode<Key, Value>::BLACK);
+        sibling->getRight()->setColor(RBNode<Key, Value>::BLACK);
+        this->rotateLeft(parentNode);
+        node = static_cast<RBNode<Key, Value>*>(this->root_);
+      }
+      else{
+        RBNode<Key, Value>* sibling = parentNode->getLeft();
+        if(isRed(sibling)){
+          sibling->setColor(RBNode<Key, Value>::BLACK);
+          parentNode->setColor(RBNode<Key, Value>::RED);
+          this->rotateRight(parentNode);
+          sibling = parentNode->getLeft();
+        }
+        if(!isRed(sibling->getLeft()) && !isRed(sibling->getRight())){
+          sibling->setColor(RBNode<Key, Value>::RED);
+          node = parentNode;
+          parentNode = node->getParent();
+          continue;
+        }
+        if(!isRed(sibling->getLeft())){
+          sibling->getRight()->setColor(RBNode<Key, Value>::BLACK);
+          sibling->setColor(RBNode<Key, Value>::RED);
+          this->rotateLeft(sibling);
+          sibling = parentNode->getLeft();
+        }
+        sibling->setColor(parentNode->getColor());
+        parentNode->setColor(RBNode<Key, Value>::BLACK);
+        sibling->getLeft()->setColor(RBNode<Key, Value>::BLACK);
+        this->rotateRight(parentNode);
+        node = static_cast<RBNode<Key, Value>*>(this->root_);
+      }
+    }
+    if(node != nullptr){
+      node->setColor(RBNode<Key, Value>::BLACK);
+    }
+}
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef SPLAYBST_H
+#define SPLAYBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include "bst.h"
+
+/**
+* A self-adjusting binary search tree. Every find/insert moves the accessed
+* node to the root with zig, zig-zig and zig-zag rotations, so frequently
+* used keys stay near the top and cost close to O(1) to reach again. Any
+* sequence of m operations costs O(m log n) amortized.
+*
+* Nodes are plain Nodes; no balance information is stored.
+*/
+template <class Key, class Value,
+          class Alloc = std::allocator<std::pair<const Key, Value> > >
+class SplayTree : public BinarySearchTree<Key, Value, Alloc>
+{
+public:
+    SplayTree();
+    explicit SplayTree(const Alloc& alloc);
+    virtual void insert(const std::pair<const Key, Value> &new_item);
+    virtual void remove(const Key& key);
+
+    // Lookups on a non-const tree splay; the const versions from the base
+    // class are still available and leave the shape alone.
+    using BinarySearchTree<Key, Value, Alloc>::find;
+    using BinarySearchTree<Key, Value, Alloc>::operator[];
+    typename BinarySearchTree<Key, Value, Alloc>::iterator find(const Key& key);
+    Value& operator[](const Key& key);
+
+protected:
+    Node<Key, Value>* splayFind(const Key& key);
+    void splay(Node<Key, Value>* node);
+};
+
+template<class Key, class Value, class Alloc>
+SplayTree<Key, Value, Alloc>::SplayTree() : BinarySearchTree<Key, Value, Alloc>()
+{
+
+}
+
+template<class Key, class Value, class Alloc>
+SplayTree<Key, Value, Alloc>::SplayTree(const Alloc& alloc) : BinarySearchTree<Key, Value, Alloc>(alloc)
+{
+
+}
+
+/*
+ * Recall: If key is already in the tree, you should
+ * overwrite the current value with the updated value.
+ * The new (or updated) node ends up at the root.
+ */
+template<class Key, class Value, class Alloc>
+void SplayTree<Key, Value, Alloc>::insert(const std::pair<const Key, Value> &new_item)
+{
+    Node<Key, Value>* currentNode = this->root_;
+    Node<Key, Value>* parentNode = nullptr;
+
+    while(currentNode != nullptr){ // walk down to the insertion point
+      parentNode = currentNode;
+      if(new_item.first < currentNode->getKey()){ // smaller keys go left
+        currentNode = currentNode->getLeft();
+      }
+      else if(new_item.first > currentNode->getKey()){ // larger keys go right
+        currentNode = currentNode->getRight();
+      }
+      else{ // key exists so update it and bring it to the top
+        currentNode->setValue(new_item.second);
+        splay(currentNode);
+        return;
+      }
+    }
+
+    Node<Key, Value>* newNode = this->template allocateNode<Node<Key, Value> >(new_item.first, new_item.second, parentNode);
+    ++this->size_;
+    if(parentNode == nullptr){ // empty tree
+      this->root_ = newNode;
+      return;
+    }
+    else if(new_item.first < parentNode->getKey()){
+      parentNode->setLeft(newNode);
+    }
+    else{
+      parentNode->setRight(newNode);
+    }
+    splay(newNode);
+}
+
+/*
+ * The node is splayed to the root first so the predecessor swap and unlink
+ * done by BinarySearchTree::remove happen right at the top.
+ */
+template<class Key, class Value, class Alloc>
+void SplayTree<Key, Value, Alloc>::remove(const Key& key)
+{
+    Node<Key, Value>* node = splayFind(key);
+    if(node == nullptr){ // nothing to remove
+      return;
+    }
+    BinarySearchTree<Key, Value, Alloc>::remove(key);
+}
+
+/**
+* Returns an iterator to the item with the given key, splaying it to the root,
+* or the end iterator if it does not exist (the last node visited is splayed).
+*/
+template<class Key, class Value, class Alloc>
+typename BinarySearchTree<Key, Value, Alloc>::iterator
+SplayTree<Key, Value, Alloc>::find(const Key& key)
+{
+    return this->makeIterator(splayFind(key));
+}
+
+/**
+ * @precondition The key exists in the map
+ * Returns the value associated with the key after splaying it to the root
+ */
+template<class Key, class Value, class Alloc>
+Value& SplayTree<Key, Value, Alloc>::operator[](const Key& key)
+{
+    Node<Key, Value>* node = splayFind(key);
+    if(node == NULL) throw std::out_of_range("Invalid key");
+    return node->getValue();
+}
+
+/**
+* Descends to key and splays whatever node was reached last, so that misses
+* also pay for themselves. Returns the matching node or NULL.
+*/
+template<class Key, class Value, class Alloc>
+Node<Key, Value>* SplayTree<Key, Value, Alloc>::splayFind(const Key& key)
+{
+    Node<Key, Value>* currentNode = this->root_;
+    Node<Key, Value>* lastNode = nullptr;
+
+    while(currentNode != nullptr){
+      lastNode = currentNode;
+      if(key < currentNode->getKey()){
+        currentNode = currentNode->getLeft();
+      }
+      else if(key > currentNode->getKey()){
+        currentNode = currentNode->getRight();
+      }
+      else{
+        break;
+      }
+    }
+
+    if(lastNode != nullptr){
+      splay(lastNode);
+    }
+    return currentNode;
+}
+
+/**
+* Moves node to the root using the rotations shared with the other trees.
+*/
+template<class Key, class Value, class Alloc>
+void SplayTree<Key, Value, Alloc>::splay(Node<Key, Value>* node)
+{
+    while(node->getParent() != nullptr){
+      Node<Key, Value>* parentNode = node->getParent();
+      Node<Key, Value>* grandparent = parentNode->getParent();
+      bool nodeIsLeft = (parentNode->getLeft() == node);
+
+      if(grandparent == nullptr){ // zig: parent is the root
+        if(nodeIsLeft) this->rotateRight(parentNode);
+        else this->rotateLeft(parentNode);
+      }
+      else if(nodeIsLeft == (grandparent->getLeft() == parentNode)){ // zig zig: rotate the grandparent first
+        if(nodeIsLeft){
+          this->rotateRight(grandparent);
+          this->rotateRight(parentNode);
+        }
+        else{
+          this->rotateLeft(grandparent);
+          this->rotateLeft(parentNode);
+        }
+      }
+      else{ // zig zag: rotate the parent, then the grandparent
+        if(nodeIsLeft){
+          this->rotateRight(parentNode);
+          this->rotateLeft(grandparent);
+        }
+        else{
+          this->rotateLeft(parentNode);
+          this->rotateRight(grandparent);
+        }
+      }
+    }
+}
+
+#endif
@@ -0,0 +1,352 @@
+#ifndef THREADEDBST_H
+#define THREADEDBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include "bst.h"
+#include "avlbst.h"
+
+/**
+* An AVLNode that also links directly to its in-order neighbours. The links
+* belong to the node object, so rotations and nodeSwap never touch them.
+*/
+template <typename Key, typename Value>
+class ThreadedAVLNode : public AVLNode<Key, Value>
+{
+public:
+    ThreadedAVLNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent);
+    virtual ~ThreadedAVLNode();
+
+    ThreadedAVLNode<Key, Value>* getNext() const;
+    ThreadedAVLNode<Key, Value>* getPrev() const;
+    void setNext(ThreadedAVLNode<Key, Value>* next);
+    void setPrev(ThreadedAVLNode<Key, Value>* prev);
+
+protected:
+    ThreadedAVLNode<Key, Value>* next_;
+    ThreadedAVLNode<Key, Value>* prev_;
+};
+
+/*
+  -------------------------------------------------
+  Begin implementations for the ThreadedAVLNode class.
+  -------------------------------------------------
+*/
+
+template<class Key, class Value>
+ThreadedAVLNode<Key, Value>::ThreadedAVLNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent) :
+    AVLNode<Key, Value>(key, value, parent), next_(NULL), prev_(NULL)
+{
+
+}
+
+template<class Key, class Value>
+ThreadedAVLNode<Key, Value>::~ThreadedAVLNode()
+{
+
+}
+
+/**
+* The in-order successor, or NULL for the largest node.
+*/
+template<class Key, class Value>
+ThreadedAVLNode<Key, Value>* ThreadedAVLNode<Key, Value>::getNext() const
+{
+    return next_;
+}
+
+/**
+* The in-order predecessor, or NULL for the smallest node.
+*/
+template<class Key, class Value>
+ThreadedAVLNode<Key, Value>* ThreadedAVLNode<Key, Value>::getPrev() const
+{
+    return prev_;
+}
+
+template<class Key, class Value>
+void ThreadedAVLNode<Key, Value>::setNext(ThreadedAVLNode<Key, Value>* next)
+{
+    next_ = next;
+}
+
+template<class Key, class Value>
+void ThreadedAVLNode<Key, Value>::setPrev(ThreadedAVLNode<Key, Value>* prev)
+{
+    prev_ = prev;
+}
+
+/*
+  -----------------------------------------------
+  End implementations for the ThreadedAVLNode class.
+  -----------------------------------------------
+*/
+
+/**
+* An AVLTree whose nodes form an in-order doubly linked list. Iterator
+* increments and decrements follow the list, so a full scan is one dependent
+* load per item instead of successor()'s climb through parent links.
+* The price is two extra pointers per node and O(1) list upkeep per
+* insert/remove.
+*/
+template <class Key, class Value,
+          class Alloc = std::allocator<std::pair<const Key, Value> > >
+class ThreadedAVLTree : public AVLTree<Key, Value, Alloc>
+{
+public:
+    ThreadedAVLTree();
+    explicit ThreadedAVLTree(const Alloc& alloc);
+    ThreadedAVLTree(const ThreadedAVLTree& other);
+    ThreadedAVLTree(ThreadedAVLTree&& other);
+    ThreadedAVLTree& operator=(const ThreadedAVLTree& other);
+    ThreadedAVLTree& operator=(ThreadedAVLTree&& other);
+    void swap(ThreadedAVLTree& other);
+    virtual ~ThreadedAVLTree();
+    virtual void remove(const Key& key);
+    virtual size_t eraseRange(const Key& lo, const Key& hi);
+    virtual void compact();
+protected:
+    virtual AVLNode<Key, Value>* createNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent);
+    virtual void destroyNode(Node<Key, Value>* node);
+    void rethread();
+    virtual Node<Key, Value>* nextNode(Node<Key, Value>* current) const;
+    virtual Node<Key, Value>* prevNode(Node<Key, Value>* current) const;
+};
+
+template<class Key, class Value, class Alloc>
+ThreadedAVLTree<Key, Value, Alloc>::ThreadedAVLTree() : AVLTree<Key, Value, Alloc>()
+{
+
+}
+
+template<class Key, class Value, class Alloc>
+ThreadedAVLTree<Key, Value, Alloc>::ThreadedAVLTree(const Alloc& alloc) : AVLTree<Key, Value, Alloc>(alloc)
+{
+
+}
+
+/**
+* Deep copy in O(n); nodes are cloned as ThreadedAVLNodes, then rethreaded.
+*/
+template<class Key, class Value, class Alloc>
+ThreadedAVLTree<Key, Value, Alloc>::ThreadedAVLTree(const ThreadedAVLTree<Key, Value, Alloc>& other) :
+    AVLTree<Key, Value, Alloc>(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.get_allocator()))
+{
+    this->template copyFrom<ThreadedAVLNode<Key, Value> >(other);
+    this->tombstoneMode_ = other.tombstoneMode_;
+    this->compactThreshold_ = other.compactThreshold_;
+    this->relaxedBound_ = other.relaxedBound_;
+    this->dead_ = other.dead_;
+    rethread();
+}
+
+/**
+* Move constructor; O(1), leaves other empty.
+*/
+template<class Key, class Value, class Alloc>
+ThreadedAVLTree<Key, Value, Alloc>::ThreadedAVLTree(ThreadedAVLTree<Key, Value, Alloc>&& other) :
+    AVLTree<Key, Value, Alloc>(std::move(other))
+{
+
+}
+
+template<class Key, class Value, class Alloc>
+ThreadedAVLTree<Key, Value, Alloc>& ThreadedAVLTree<Key, Value, Alloc>::operator=(const ThreadedAVLTree<Key, Value, Alloc>& other)
+{
+    if(this != &other){
+      ThreadedAVLTree<Key, Value, Alloc> copy(other);
+      this->swapTree(copy);
+    }
+    return *this;
+}
+
+/**
+* Move assignment in O(1) by swapping contents.
+*/
+template<class Key, class Value, class Alloc>
+ThreadedAVLTree<Key, Value, Alloc>& ThreadedAVLTree<Key, Value, Alloc>::operator=(ThreadedAVLTree<Key, Value, Alloc>&& other)
+{
+    this->swapTree(other);
+    return *this;
+}
+
+template<class Key, class Value, class Alloc>
+void ThreadedAVLTree<Key, Value, Alloc>::swap(ThreadedAVLTree<Key, Value, Alloc>& other)
+{
+    this->swapTree(other);
+}
+
+/**
+* Frees the nodes here so they are freed as ThreadedAVLNodes.
+*/
+template<class Key, class Value, class Alloc>
+ThreadedAVLTree<Key, Value, Alloc>::~ThreadedAVLTree()
+{
+    this->clear();
+}
+
+/**
+* Unlinks the node from the thread, then removes it from the tree as usual.
+* Tombstones stay threaded until compact() frees them.
+*/
+template<class Key, class Value, class Alloc>
+void ThreadedAVLTree<Key, Value, Alloc>::remove(const Key& key)
+{
+    ThreadedAVLNode<Key, Value>* node = static_cast<ThreadedAVLNode<Key, Value>*>(this->internalFind(key));
+    if(node == nullptr){
+      return;
+    }
+    if(this->tombstoneMode_){
+      AVLTree<Key, Value, Alloc>::remove(key);
+      return;
+    }
+    if(node->getPrev() != nullptr){
+      node->getPrev()->setNext(node->getNext());
+    }
+    if(node->getNext() != nullptr){
+      node->getNext()->setPrev(node->getPrev());
+    }
+    AVLTree<Key, Value, Alloc>::remove(key);
+}
+
+/**
+* The range is one run of the thread, tombstones included: splice it out,
+* then let AVLTree::eraseRange cut it from the tree.
+*/
+template<class Key, class Value, class Alloc>
+size_t ThreadedAVLTree<Key, Value, Alloc>::eraseRange(const Key& lo, const Key& hi)
+{
+    if(hi < lo){
+      return 0;
+    }
+    ThreadedAVLNode<Key, Value>* first = nullptr; // smallest node >= lo, live or not
+    Node<Key, Value>* node = this->root_;
+    while(node != nullptr){
+      if(node->getKey() < lo){
+        node = node->getRight();
+      }
+      else{
+        first = static_cast<ThreadedAVLNode<Key, Value>*>(node);
+        node = node->getLeft();
+      }
+    }
+    if(first == nullptr || hi < first->getKey()){
+      return 0;
+    }
+    ThreadedAVLNode<Key, Value>* after = first;
+    while(after != nullptr && !(hi < after->getKey())){
+      after = after->getNext();
+    }
+    if(first->getPrev() != nullptr){
+      first->getPrev()->setNext(after);
+    }
+    if(after != nullptr){
+      after->setPrev(first->getPrev());
+    }
+    return AVLTree<Key, Value, Alloc>::eraseRange(lo, hi);
+}
+
+/**
+* Drops the dead nodes from the thread before AVLTree::compact frees them.
+*/
+template<class Key, class Value, class Alloc>
+void ThreadedAVLTree<Key, Value, Alloc>::compact()
+{
+    if(this->dead_ == 0){
+      return;
+    }
+    ThreadedAVLNode<Key, Value>* node = static_cast<ThreadedAVLNode<Key, Value>*>(this->getSmallestNode());
+    while(node != nullptr){
+      ThreadedAVLNode<Key, Value>* next = node->getNext();
+      if(node->isDead()){
+        if(node->getPrev() != nullptr){
+          node->getPrev()->setNext(next);
+        }
+        if(next != nullptr){
+          next->setPrev(node->getPrev());
+        }
+      }
+      node = next;
+    }
+    AVLTree<Key, Value, Alloc>::compact();
+}
+
+/**
+* A new key always becomes a leaf, so its neighbours follow from the parent:
+* a left child sits right before its parent, a right child right after it.
+*/
+template<class Key, class Value, class Alloc>
+AVLNode<Key, Value>* ThreadedAVLTree<Key, Value, Alloc>::createNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent)
+{
+    ThreadedAVLNode<Key, Value>* node = this->template allocateNode<ThreadedAVLNode<Key, Value> >(key, value, parent);
+    ThreadedAVLNode<Key, Value>* parentNode = static_cast<ThreadedAVLNode<Key, Value>*>(parent);
+    if(parentNode == nullptr){ // first node of the tree
+      return node;
+    }
+
+    if(key < parentNode->getKey()){ // goes between the parent's predecessor and the parent
+      node->setPrev(parentNode->getPrev());
+      node->setNext(parentNode);
+    }
+    else{ // goes between the parent and its successor
+      node->setPrev(parentNode);
+      node->setNext(parentNode->getNext());
+    }
+    if(node->getPrev() != nullptr){
+      node->getPrev()->setNext(node);
+    }
+    if(node->getNext() != nullptr){
+      node->getNext()->setPrev(node);
+    }
+    return node;
+}
+
+template<class Key, class Value, class Alloc>
+void ThreadedAVLTree<Key, Value, Alloc>::destroyNode(Node<Key, Value>* node)
+{
+    this->deallocateNode(static_cast<ThreadedAVLNode<Key, Value>*>(node));
+}
+
+/**
+* Rebuilds every next/prev link with one in-order walk, e.g. after the nodes
+* were cloned from another tree.
+*/
+template<class Key, class Value, class Alloc>
+void ThreadedAVLTree<Key, Value, Alloc>::rethread()
+{
+    ThreadedAVLNode<Key, Value>* prev = nullptr;
+    Node<Key, Value>* current = this->getSmallestNode();
+    while(current != nullptr){
+      ThreadedAVLNode<Key, Value>* node = static_cast<ThreadedAVLNode<Key, Value>*>(current);
+      node->setPrev(prev);
+      node->setNext(nullptr);
+      if(prev != nullptr){
+        prev->setNext(node);
+      }
+      prev = node;
+      current = BinarySearchTree<Key, Value, Alloc>::successor(current);
+    }
+}
+
+template<class Key, class Value, class Alloc>
+Node<Key, Value>* ThreadedAVLTree<Key, Value, Alloc>::nextNode(Node<Key, Value>* current) const
+{
+    ThreadedAVLNode<Key, Value>* node = static_cast<ThreadedAVLNode<Key, Value>*>(current)->getNext();
+    while(node != nullptr && node->isDead()){ // tombstones are still threaded
+      node = node->getNext();
+    }
+    return node;
+}
+
+template<class Key, class Value, class Alloc>
+Node<Key, Value>* ThreadedAVLTree<Key, Value, Alloc>::prevNode(Node<Key, Value>* current) const
+{
+    ThreadedAVLNode<Key, Value>* node = static_cast<ThreadedAVLNode<Key, Value>*>(current)->getPrev();
+    while(node != nullptr && node->isDead()){
+      node = node->getPrev();
+    }
+    return node;
+}
+
+#endif
@@ -0,0 +1,151 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <chrono>
+#include "bst.h"
+#include "avlbst.h"
+#include "trace.h"
+
+using namespace std;
+
+// Replays a recorded trace of (long long, long long) operations against
+// one tree at full speed and reports the time taken by each phase.
+//
+// usage: trace-replay <trace> [tree]
+//        trace-replay --record <trace> [num_keys] [operations]
+//   tree is one of avl, bst, map (std::map), or all (the default)
+//   --record writes a sample trace through a RecordedTree: a "load" phase of
+//   num_keys random inserts, then a "mixed" phase of 50% finds, 25% inserts
+//   and 25% removes, then a "drain" phase that removes every loaded key
+
+typedef TraceRecord<long long, long long> Record;
+
+// std::map with the tree interface replay() needs; insert overwrites like
+// the trees do.
+struct MapTree {
+    map<long long, long long> items;
+
+    void insert(const pair<const long long, long long>& item) { items[item.first] = item.second; }
+    void remove(long long key) { items.erase(key); }
+    bool contains(long long key) const { return items.find(key) != items.end(); }
+    size_t size() const { return items.size(); }
+};
+
+template<typename Tree>
+bool contains(Tree& tree, long long key)
+{
+    return tree.find(key) != tree.end();
+}
+
+bool contains(MapTree& tree, long long key)
+{
+    return tree.contains(key);
+}
+
+template<typename Tree>
+void replay(const char* name, const vector<Record>& records)
+{
+    typedef chrono::steady_clock Clock;
+    Tree tree;
+    string phase = "trace";
+    size_t ops = 0;
+    long long hits = 0;
+    double total = 0;
+    Clock::time_point start = Clock::now();
+
+    cout << name << ":" << endl;
+    for(size_t i = 0; i <= records.size(); ++i){
+      if(i == records.size() || records[i].op == TRACE_PHASE){
+        double ms = chrono::duration<double, milli>(Clock::now() - start).count();
+        if(ops > 0){
+          cout << "  " << phase << ": " << ops << " ops in " << ms << " ms, "
+               << ops / ms / 1000 << " Mops/s, " << tree.size() << " keys" << endl;
+        }
+        total += ms;
+        if(i == records.size()){
+          break;
+        }
+        phase = records[i].name;
+        ops = 0;
+        start = Clock::now();
+        continue;
+      }
+      const Record& record = records[i];
+      if(record.op == TRACE_INSERT){
+        tree.insert(make_pair(record.key, record.value));
+      }
+      else if(record.op == TRACE_REMOVE){
+        tree.remove(record.key);
+      }
+      else if(contains(tree, record.key)){
+        ++hits;
+      }
+      ++ops;
+    }
+    cout << "  total: " << total << " ms, " << hits << " finds hit" << endl;
+}
+
+int record(const char* path, int numKeys, int operations)
+{
+    RecordedTree<AVLTree<long long, long long> > recorded(path);
+    mt19937 rng(104);
+    uniform_int_distribution<long long> keyDist(0, 4LL * numKeys);
+    vector<long long> loaded(numKeys);
+
+    recorded.phase("load");
+    for(int i = 0; i < numKeys; ++i){
+      loaded[i] = keyDist(rng);
+      recorded.insert(make_pair(loaded[i], (long long)i));
+    }
+    recorded.phase("mixed");
+    for(int i = 0; i < operations; ++i){
+      int roll = rng() % 4;
+      long long key = keyDist(rng);
+      if(roll == 0) recorded.insert(make_pair(key, key));
+      else if(roll == 1) recorded.remove(key);
+      else recorded.find(key);
+    }
+    recorded.phase("drain");
+    for(int i = 0; i < numKeys; ++i){
+      recorded.remove(loaded[i]);
+    }
+    cout << "wrote " << recorded.trace().records() << " records to " << path << endl;
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc < 2 || (strcmp(argv[1], "--record") == 0 && argc < 3)){
+      cerr << "usage: trace-replay <trace> [avl|bst|map|all]" << endl
+           << "       trace-replay --record <trace> [num_keys] [operations]" << endl;
+      return 1;
+    }
+
+    try{
+      if(strcmp(argv[1], "--record") == 0){
+        int numKeys = (argc > 3) ? atoi(argv[3]) : 200000;
+        int operations = (argc > 4) ? atoi(argv[4]) : 1000000;
+        return record(argv[2], numKeys, operations);
+      }
+
+      string tree = (argc > 2) ? argv[2] : "all";
+      if(tree != "avl" && tree != "bst" && tree != "map" && tree != "all"){
+        cerr << "unknown tree " << tree << endl;
+        return 1;
+      }
+      vector<Record> records = TraceReader<long long, long long>::read(argv[1]);
+      cout << records.size() << " records" << endl;
+      if(tree == "avl" || tree == "all") replay<AVLTree<long long, long long> >("AVLTree", records);
+      if(tree == "bst" || tree == "all") replay<BinarySearchTree<long long, long long> >("BinarySearchTree", records);
+      if(tree == "map" || tree == "all") replay<MapTree>("std::map", records);
+    }
+    catch(const exception& error){
+      cerr << error.what() << endl;
+      return 1;
+    }
+    return 0;
+}
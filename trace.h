@@ -0,0 +1,228 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+// Operation traces for reproducing a tree's history.
+//
+// A trace is a small header followed by one record per operation: an op
+// byte, then the raw key, then the raw value for inserts or the name for
+// phase markers. Keys and values must be trivially copyable; the header
+// stores their sizes so a replay can refuse a trace of the wrong type.
+// TraceWriter buffers records and writes them 64 KB at a time, so
+// recording costs about a memcpy per operation.
+//
+// RecordedTree wraps any of the trees the same way TimedTree does and logs
+// every insert, remove and find that goes through it. TraceReader decodes
+// a trace back into a vector of TraceRecords, so a replay can run the
+// operations without any decoding or I/O in the timed loop.
+
+enum TraceOp { TRACE_INSERT, TRACE_REMOVE, TRACE_FIND, TRACE_PHASE };
+
+template<typename Key, typename Value>
+struct TraceRecord
+{
+    TraceOp op;
+    Key key;
+    Value value;        // inserts only
+    std::string name;   // phase markers only
+};
+
+static const char TRACE_MAGIC[8] = { 'B', 'S', 'T', 'T', 'R', 'A', 'C', '1' };
+
+template<typename Key, typename Value>
+class TraceWriter
+{
+public:
+    static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value,
+                  "traced keys and values must be trivially copyable");
+
+    explicit TraceWriter(const std::string& path) : out_(path.c_str(), std::ios::binary), records_(0)
+    {
+        if(!out_){
+          throw std::runtime_error("cannot write " + path);
+        }
+        buffer_.reserve(BUFFER_SIZE);
+        append(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        uint8_t sizes[2] = { (uint8_t)sizeof(Key), (uint8_t)sizeof(Value) };
+        append(sizes, sizeof(sizes));
+    }
+
+    ~TraceWriter()
+    {
+        flush();
+    }
+
+    void insert(const Key& key, const Value& value)
+    {
+        appendOp(TRACE_INSERT, key);
+        append(&value, sizeof(Value));
+    }
+
+    void remove(const Key& key) { appendOp(TRACE_REMOVE, key); }
+    void find(const Key& key) { appendOp(TRACE_FIND, key); }
+
+    // Starts a new named phase; replay reports each phase's time separately.
+    void phase(const std::string& name)
+    {
+        uint8_t op = TRACE_PHASE;
+        uint8_t length = (uint8_t)std::min<size_t>(name.size(), 255);
+        append(&op, 1);
+        append(&length, 1);
+        append(name.data(), length);
+        ++records_;
+    }
+
+    void flush()
+    {
+        if(!buffer_.empty()){
+          out_.write(&buffer_[0], buffer_.size());
+          buffer_.clear();
+        }
+        out_.flush();
+    }
+
+    uint64_t records() const { return records_; }
+
+protected:
+    static const size_t BUFFER_SIZE = 64 * 1024;
+
+    void appendOp(TraceOp op, const Key& key)
+    {
+        uint8_t byte = (uint8_t)op;
+        append(&byte, 1);
+        append(&key, sizeof(Key));
+        ++records_;
+    }
+
+    void append(const void* data, size_t size)
+    {
+        if(buffer_.size() + size > BUFFER_SIZE){
+          flush();
+        }
+        const char* bytes = static_cast<const char*>(data);
+        buffer_.insert(buffer_.end(), bytes, bytes + size);
+    }
+
+    std::ofstream out_;
+    std::vector<char> buffer_;
+    uint64_t records_;
+};
+
+// Wraps a tree and records every operation that goes through the wrapper.
+// The tree itself stays reachable through tree() for unrecorded access.
+template<typename Tree>
+class RecordedTree
+{
+public:
+    typedef typename Tree::iterator iterator;
+    typedef typename iterator::value_type Item;
+    typedef typename std::remove_const<typename Item::first_type>::type Key;
+    typedef typename Item::second_type Value;
+
+    explicit RecordedTree(const std::string& path) : trace_(path)
+    {
+
+    }
+
+    void insert(const Item& item)
+    {
+        trace_.insert(item.first, item.second);
+        tree_.insert(item);
+    }
+
+    void remove(const Key& key)
+    {
+        trace_.remove(key);
+        tree_.remove(key);
+    }
+
+    iterator find(const Key& key)
+    {
+        trace_.find(key);
+        return tree_.find(key);
+    }
+
+    void phase(const std::string& name) { trace_.phase(name); }
+
+    Tree& tree() { return tree_; }
+    const Tree& tree() const { return tree_; }
+    TraceWriter<Key, Value>& trace() { return trace_; }
+
+protected:
+    Tree tree_;
+    TraceWriter<Key, Value> trace_;
+};
+
+template<typename Key, typename Value>
+class TraceReader
+{
+public:
+    // Reads and decodes the whole trace at path. Throws runtime_error if it
+    // is not a trace, was written with other key/value sizes, or is cut
+    // short.
+    static std::vector<TraceRecord<Key, Value> > read(const std::string& path)
+    {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        if(!in){
+          throw std::runtime_error("cannot read " + path);
+        }
+        std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        size_t pos = sizeof(TRACE_MAGIC) + 2;
+        if(data.size() < pos || std::memcmp(&data[0], TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0){
+          throw std::runtime_error(path + " is not a tree trace");
+        }
+        if((uint8_t)data[8] != sizeof(Key) || (uint8_t)data[9] != sizeof(Value)){
+          throw std::runtime_error(path + " was recorded with different key or value sizes");
+        }
+
+        std::vector<TraceRecord<Key, Value> > records;
+        while(pos < data.size()){
+          TraceRecord<Key, Value> record = TraceRecord<Key, Value>();
+          uint8_t op = (uint8_t)data[pos++];
+          if(op > TRACE_PHASE){
+            throw std::runtime_error("bad trace record at byte " + std::to_string(pos - 1));
+          }
+          record.op = (TraceOp)op;
+          if(record.op == TRACE_PHASE){
+            need(data, pos, 1);
+            size_t length = (uint8_t)data[pos++];
+            need(data, pos, length);
+            record.name.assign(&data[pos], length);
+            pos += length;
+          }
+          else{
+            need(data, pos, sizeof(Key));
+            std::memcpy(&record.key, &data[pos], sizeof(Key));
+            pos += sizeof(Key);
+            if(record.op == TRACE_INSERT){
+              need(data, pos, sizeof(Value));
+              std::memcpy(&record.value, &data[pos], sizeof(Value));
+              pos += sizeof(Value);
+            }
+          }
+          records.push_back(record);
+        }
+        return records;
+    }
+
+protected:
+    static void need(const std::vector<char>& data, size_t pos, size_t size)
+    {
+        if(data.size() - pos < size){
+          throw std::runtime_error("trace ends in the middle of a record");
+        }
+    }
+};
+
+#endif
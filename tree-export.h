@@ -0,0 +1,311 @@
+#ifndef TREE_EXPORT_H
+#define TREE_EXPORT_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <type_traits>
+#include "bst.h"
+
+// Streaming tree export to Graphviz DOT and JSON.
+//
+// Unlike prettyPrintBST, which stops at PPBST_MAX_HEIGHT levels and builds
+// maps/vectors of the whole tree, these walk the tree once using parent
+// links, so they take O(n) time and O(1) extra memory and work on trees of
+// any size and depth.
+
+// Controls what part of the tree gets written.
+struct ExportOptions
+{
+    // Levels to write below the starting node; deeper subtrees are replaced
+    // by a "..." marker. -1 writes everything.
+    int maxDepth;
+
+    // Sampling: of the nodes at depth sampleDepth (relative to the start),
+    // only every sampleEvery-th one has its subtree expanded; the others are
+    // written as a single collapsed node. 1 expands everything.
+    int sampleDepth;
+    size_t sampleEvery;
+
+    ExportOptions() : maxDepth(-1), sampleDepth(0), sampleEvery(1) {}
+};
+
+// Returns the node to start exporting at: the root, or the node holding
+// *key (NULL if the key is missing). Friend of BinarySearchTree.
+template<typename Key, typename Value, typename Alloc>
+Node<Key, Value>* exportStartNode(const BinarySearchTree<Key, Value, Alloc>& tree, const Key* key)
+{
+    if(key == nullptr)
+    {
+        return tree.root_;
+    }
+    return tree.internalFind(*key);
+}
+
+// Whether node holds a live item; false for AVLTree tombstones. Friend of
+// BinarySearchTree.
+template<typename Key, typename Value, typename Alloc>
+bool exportNodeVisible(const BinarySearchTree<Key, Value, Alloc>& tree, Node<Key, Value>* node)
+{
+    return tree.isVisible(node);
+}
+
+// Walks the subtree at start in preorder without recursion or a stack,
+// calling visitor.enter(node, depth, expand) on the way down and
+// visitor.leave(node, expanded) on the way back up. visitor.descend(node,
+// isLeft) is called right before moving into a child.
+template<typename Key, typename Value, typename Visitor>
+void exportWalk(Node<Key, Value>* start, const ExportOptions& options, Visitor& visitor)
+{
+    if(start == nullptr)
+    {
+        return;
+    }
+
+    Node<Key, Value>* node = start;
+    Node<Key, Value>* prev = start->getParent(); // "came from above"
+    int depth = 0;
+    size_t sampleCounter = 0;
+
+    while(true)
+    {
+        Node<Key, Value>* next = nullptr;
+        bool goUp = false;
+
+        bool fromLeft = prev != nullptr && prev == node->getLeft();
+        bool fromRight = prev != nullptr && prev == node->getRight();
+
+        if(!fromLeft && !fromRight)
+        {
+            // first visit: decide whether to open this subtree
+            bool hasChildren = node->getLeft() != nullptr || node->getRight() != nullptr;
+            bool expand = hasChildren && (options.maxDepth < 0 || depth < options.maxDepth);
+            if(expand && depth == options.sampleDepth && options.sampleEvery > 1)
+            {
+                expand = (sampleCounter++ % options.sampleEvery) == 0;
+            }
+            visitor.enter(node, depth, expand);
+
+            if(expand && node->getLeft() != nullptr)
+            {
+                visitor.descend(node, true);
+                next = node->getLeft();
+            }
+            else if(expand && node->getRight() != nullptr)
+            {
+                visitor.descend(node, false);
+                next = node->getRight();
+            }
+            else
+            {
+                visitor.leave(node, expand);
+                goUp = true;
+            }
+        }
+        else if(fromLeft)
+        {
+            // back from the left child; the node was expanded or we would not have gone there
+            if(node->getRight() != nullptr)
+            {
+                visitor.descend(node, false);
+                next = node->getRight();
+            }
+            else
+            {
+                visitor.leave(node, true);
+                goUp = true;
+            }
+        }
+        else
+        {
+            // back from the right child
+            visitor.leave(node, true);
+            goUp = true;
+        }
+
+        if(goUp)
+        {
+            if(node == start)
+            {
+                return;
+            }
+            next = node->getParent();
+            --depth;
+        }
+        else
+        {
+            ++depth;
+        }
+        prev = node;
+        node = next;
+    }
+}
+
+// Writes a value as a JSON number when it is one, otherwise as a string.
+// Character types print as text, so they count as strings.
+template<typename T>
+struct ExportIsNumber
+{
+    static const bool value = std::is_arithmetic<T>::value &&
+        !std::is_same<T, char>::value && !std::is_same<T, signed char>::value &&
+        !std::is_same<T, unsigned char>::value && !std::is_same<T, bool>::value;
+};
+
+template<typename T>
+typename std::enable_if<ExportIsNumber<T>::value>::type
+exportJSONValue(std::ostream& out, const T& value)
+{
+    out << value;
+}
+
+template<typename T>
+typename std::enable_if<!ExportIsNumber<T>::value>::type
+exportJSONValue(std::ostream& out, const T& value)
+{
+    std::ostringstream text;
+    text << value;
+    const std::string& s = text.str();
+    out << '"';
+    for(size_t i = 0; i < s.size(); ++i)
+    {
+        if(s[i] == '"' || s[i] == '\\')
+        {
+            out << '\\' << s[i];
+        }
+        else if((unsigned char)s[i] < 0x20)
+        {
+            out << ' ';
+        }
+        else
+        {
+            out << s[i];
+        }
+    }
+    out << '"';
+}
+
+// Escapes a DOT label.
+template<typename T>
+void exportDOTLabel(std::ostream& out, const T& value)
+{
+    std::ostringstream text;
+    text << value;
+    const std::string& s = text.str();
+    for(size_t i = 0; i < s.size(); ++i)
+    {
+        if(s[i] == '"' || s[i] == '\\')
+        {
+            out << '\\';
+        }
+        out << s[i];
+    }
+}
+
+template<typename Key, typename Value, typename Alloc>
+class DOTExportVisitor
+{
+public:
+    DOTExportVisitor(std::ostream& out, const BinarySearchTree<Key, Value, Alloc>& tree) : out_(out), tree_(tree) {}
+
+    void enter(Node<Key, Value>* node, int depth, bool expand)
+    {
+        out_ << "  n" << (const void*)node << " [label=\"";
+        exportDOTLabel(out_, node->getKey());
+        out_ << ": ";
+        exportDOTLabel(out_, node->getValue());
+        out_ << "\"";
+        if(!exportNodeVisible(tree_, node))
+        {
+            // removed, still linked in until compaction
+            out_ << ", style=dashed, color=grey, fontcolor=grey";
+        }
+        out_ << "];\n";
+        if(node->getParent() != nullptr && depth > 0)
+        {
+            out_ << "  n" << (const void*)node->getParent() << " -> n" << (const void*)node << ";\n";
+        }
+        if(!expand && (node->getLeft() != nullptr || node->getRight() != nullptr))
+        {
+            // subtree cut off by depth limit or sampling
+            out_ << "  m" << (const void*)node << " [label=\"...\", shape=plaintext];\n";
+            out_ << "  n" << (const void*)node << " -> m" << (const void*)node << " [style=dashed];\n";
+        }
+    }
+
+    void descend(Node<Key, Value>*, bool) {}
+    void leave(Node<Key, Value>*, bool) {}
+
+private:
+    std::ostream& out_;
+    const BinarySearchTree<Key, Value, Alloc>& tree_;
+};
+
+template<typename Key, typename Value, typename Alloc>
+class JSONExportVisitor
+{
+public:
+    JSONExportVisitor(std::ostream& out, const BinarySearchTree<Key, Value, Alloc>& tree) : out_(out), tree_(tree) {}
+
+    void enter(Node<Key, Value>* node, int, bool expand)
+    {
+        out_ << "{\"key\":";
+        exportJSONValue(out_, node->getKey());
+        out_ << ",\"value\":";
+        exportJSONValue(out_, node->getValue());
+        if(!exportNodeVisible(tree_, node))
+        {
+            out_ << ",\"dead\":true";
+        }
+        if(!expand && (node->getLeft() != nullptr || node->getRight() != nullptr))
+        {
+            out_ << ",\"truncated\":true";
+        }
+    }
+
+    void descend(Node<Key, Value>*, bool isLeft)
+    {
+        out_ << (isLeft ? ",\"left\":" : ",\"right\":");
+    }
+
+    void leave(Node<Key, Value>*, bool)
+    {
+        out_ << "}";
+    }
+
+private:
+    std::ostream& out_;
+    const BinarySearchTree<Key, Value, Alloc>& tree_;
+};
+
+// Writes the tree (or the subtree at subtreeRoot) as a Graphviz digraph.
+// Dead (tombstoned) nodes are drawn dashed and grey.
+template<typename Key, typename Value, typename Alloc>
+void exportDOT(const BinarySearchTree<Key, Value, Alloc>& tree, std::ostream& out,
+               const ExportOptions& options = ExportOptions(), const Key* subtreeRoot = nullptr)
+{
+    DOTExportVisitor<Key, Value, Alloc> visitor(out, tree);
+    out << "digraph BST {\n";
+    exportWalk(exportStartNode(tree, subtreeRoot), options, visitor);
+    out << "}\n";
+}
+
+// Writes the tree (or the subtree at subtreeRoot) as nested JSON objects
+// with "key", "value", "left", "right", "dead":true for tombstoned nodes
+// and, for cut-off subtrees, "truncated". An empty tree is written as null.
+template<typename Key, typename Value, typename Alloc>
+void exportJSON(const BinarySearchTree<Key, Value, Alloc>& tree, std::ostream& out,
+                const ExportOptions& options = ExportOptions(), const Key* subtreeRoot = nullptr)
+{
+    Node<Key, Value>* start = exportStartNode(tree, subtreeRoot);
+    if(start == nullptr)
+    {
+        out << "null\n";
+        return;
+    }
+    JSONExportVisitor<Key, Value, Alloc> visitor(out, tree);
+    exportWalk(start, options, visitor);
+    out << "\n";
+}
+
+#endif